@@ -0,0 +1,854 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Benchmarks of the lists against the standard containers
+////////////////////////////////////////////////////////////////////////////////
+
+//   Build and run with 'make bench', arguments are given with BENCH_ARGS:
+//     --sizes 10,1000,100000,1000000,10000000
+//                              Number of elements of the containers
+//     --payloads 4,64,256      Size of an element in bytes
+//     --format csv|json        Format of the results on the standard output
+//     --threads 1,2,4,8        Threads of the multi-threaded cases
+//   Every case runs in its own process so that the peak RSS is its own.
+//   The multi-threaded cases use a read-mostly mix of finding (90%),
+//   adding (5%) and removing (5%) values, comparing the lock-free list
+//   with a list behind a mutex. Their allocations are not counted.
+//   list_t+split_data is list_t with the data of every element allocated
+//   apart from it, as before the data was placed after the element.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <forward_list>
+#include <list>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define LIST_IMPL
+#include "list.hpp"
+#include "dlist.hpp"
+#include "ulist.hpp"
+#include "lflist.hpp"
+#include "skiplist.h"
+#include "tlist.hpp"
+
+// Allocations made by the container being measured
+static size_t allocations = 0;
+
+template<size_t bytes>
+struct payload_t
+{
+	unsigned char data[bytes];
+};
+
+template<typename type_t>
+struct counting_allocator
+{
+	using value_type = type_t;
+
+	counting_allocator() = default;
+	template<typename other_t>
+	counting_allocator(const counting_allocator<other_t> &) {}
+
+	type_t *allocate(size_t count)
+	{
+		allocations++;
+		return std::allocator<type_t>().allocate(count);
+	}
+	void deallocate(type_t *pointer, size_t count)
+	{
+		std::allocator<type_t>().deallocate(pointer, count);
+	}
+
+	template<typename other_t>
+	bool operator==(const counting_allocator<other_t> &) const
+	{
+		return true;
+	}
+	template<typename other_t>
+	bool operator!=(const counting_allocator<other_t> &) const
+	{
+		return false;
+	}
+};
+
+static void *counting_allocate(void *context, size_t size)
+{
+	(void) context;
+	allocations++;
+	return malloc(size);
+}
+
+static void counting_deallocate(void *context, void *pointer, size_t size)
+{
+	(void) context;
+	(void) size;
+	free(pointer);
+}
+
+static const list_allocator_t counting_list_allocator = {
+	counting_allocate, counting_deallocate, nullptr, nullptr
+};
+
+// Only the element is allocated, its data is allocated apart
+static void *split_allocate(void *context, size_t size)
+{
+	(void) context;
+	(void) size;
+	allocations++;
+	return malloc(sizeof(element_t));
+}
+
+static const list_allocator_t split_list_allocator = {
+	split_allocate, counting_deallocate, nullptr, nullptr
+};
+
+// Containers are measured through adapters with the same methods
+
+template<typename type_t>
+class c_list_adapter
+{
+	list_t *list = create_list_with_allocator(sizeof(type_t),
+	               &counting_list_allocator);
+public:
+	static const char *name() { return "list_t"; }
+	~c_list_adapter() { delete_list(list); }
+	void push_back(const type_t &value)
+	{
+		*(type_t *) add_element(list->size, list)->data = value;
+	}
+	void push_front(const type_t &value)
+	{
+		*(type_t *) add_element(0, list)->data = value;
+	}
+	void insert(size_t index, const type_t &value)
+	{
+		*(type_t *) add_element(index, list)->data = value;
+	}
+	void erase(size_t index) { remove_element(index, list); }
+	type_t &at(size_t index)
+	{
+		return *(type_t *) get_element(index, list)->data;
+	}
+	template<typename function_t>
+	void for_each(function_t function)
+	{
+		for (element_t *element = (element_t *) list->base->next; element;
+		     element = (element_t *) element->next) {
+			function(*(type_t *) element->data);
+		}
+	}
+	void clear() { clear_list(list); }
+};
+
+// The layout of the elements before their data was allocated with them,
+// the same list with the data of every element in a second allocation
+template<typename type_t>
+class c_split_list_adapter
+{
+	list_t *list = create_list_with_allocator(sizeof(type_t),
+	               &split_list_allocator);
+
+	void add(size_t index, const type_t &value)
+	{
+		element_t *element = add_element(index, list);
+		allocations++;
+		element->data = malloc(sizeof(type_t));
+		*(type_t *) element->data = value;
+	}
+public:
+	static const char *name() { return "list_t+split_data"; }
+	~c_split_list_adapter()
+	{
+		clear();
+		delete_list(list);
+	}
+	void push_back(const type_t &value) { add(list->size, value); }
+	void push_front(const type_t &value) { add(0, value); }
+	void insert(size_t index, const type_t &value) { add(index, value); }
+	void erase(size_t index)
+	{
+		// Removing continues from the element before, it is not walked again
+		element_t *prev = get_element(index - 1, list);
+		free(((element_t *) prev->next)->data);
+		remove_element(index, list);
+	}
+	type_t &at(size_t index)
+	{
+		return *(type_t *) get_element(index, list)->data;
+	}
+	template<typename function_t>
+	void for_each(function_t function)
+	{
+		for (element_t *element = (element_t *) list->base->next; element;
+		     element = (element_t *) element->next) {
+			function(*(type_t *) element->data);
+		}
+	}
+	void clear()
+	{
+		for (element_t *element = (element_t *) list->base->next; element;
+		     element = (element_t *) element->next) {
+			free(element->data);
+		}
+		clear_list(list);
+	}
+};
+
+template<typename type_t>
+class c_dlist_adapter
+{
+	dlist_t *list = create_dlist_with_allocator(sizeof(type_t),
+	                &counting_list_allocator);
+public:
+	static const char *name() { return "dlist_t"; }
+	~c_dlist_adapter() { delete_dlist(list); }
+	void push_back(const type_t &value)
+	{
+		*(type_t *) add_delement(list->size, list)->data = value;
+	}
+	void push_front(const type_t &value)
+	{
+		*(type_t *) add_delement(0, list)->data = value;
+	}
+	void insert(size_t index, const type_t &value)
+	{
+		*(type_t *) add_delement(index, list)->data = value;
+	}
+	void erase(size_t index) { remove_delement(index, list); }
+	type_t &at(size_t index)
+	{
+		return *(type_t *) get_delement(index, list)->data;
+	}
+	template<typename function_t>
+	void for_each(function_t function)
+	{
+		for (delement_t *element = (delement_t *) list->base->next;
+		     element != list->base; element = (delement_t *) element->next) {
+			function(*(type_t *) element->data);
+		}
+	}
+	void clear() { clear_dlist(list); }
+};
+
+template<typename type_t>
+class c_ulist_adapter
+{
+	ulist_t *list = create_ulist_with_allocator(sizeof(type_t), 0,
+	                &counting_list_allocator);
+public:
+	static const char *name() { return "ulist_t"; }
+	~c_ulist_adapter() { delete_ulist(list); }
+	void push_back(const type_t &value)
+	{
+		*(type_t *) add_uelement(list->size, list) = value;
+	}
+	void push_front(const type_t &value)
+	{
+		*(type_t *) add_uelement(0, list) = value;
+	}
+	void insert(size_t index, const type_t &value)
+	{
+		*(type_t *) add_uelement(index, list) = value;
+	}
+	void erase(size_t index) { remove_uelement(index, list); }
+	type_t &at(size_t index) { return *(type_t *) get_uelement(index, list); }
+	template<typename function_t>
+	void for_each(function_t function)
+	{
+		for (uchunk_t *chunk = list->head; chunk;
+		     chunk = (uchunk_t *) chunk->next) {
+			type_t *data = (type_t *) get_uchunk_data(chunk, 0, list);
+			for (size_t i = 0; i < chunk->count; i++) {
+				function(data[i]);
+			}
+		}
+	}
+	void clear() { clear_ulist(list); }
+};
+
+template<typename type_t>
+class c_skiplist_adapter
+{
+	skiplist_t *list = create_skiplist_with_allocator(sizeof(type_t), nullptr,
+	                   &counting_list_allocator);
+public:
+	static const char *name() { return "skiplist_t"; }
+	~c_skiplist_adapter() { delete_skiplist(list); }
+	void push_back(const type_t &value)
+	{
+		*(type_t *) add_selement(list->size, list)->data = value;
+	}
+	void push_front(const type_t &value)
+	{
+		*(type_t *) add_selement(0, list)->data = value;
+	}
+	void insert(size_t index, const type_t &value)
+	{
+		*(type_t *) add_selement(index, list)->data = value;
+	}
+	void erase(size_t index) { remove_selement(index, list); }
+	type_t &at(size_t index)
+	{
+		return *(type_t *) get_selement(index, list)->data;
+	}
+	template<typename function_t>
+	void for_each(function_t function)
+	{
+		for (selement_t *element = (selement_t *) list->base->next; element;
+		     element = (selement_t *) element->next) {
+			function(*(type_t *) element->data);
+		}
+	}
+	void clear() { clear_skiplist(list); }
+};
+
+template<typename type_t, typename backend_t>
+class aplib_adapter
+{
+	aplib::list<type_t, counting_allocator<type_t>, backend_t> list;
+public:
+	static const char *name()
+	{
+		if (std::is_same<backend_t, aplib::doubly_linked>::value) {
+			return "aplib::dlist";
+		}
+		if (std::is_same<backend_t, aplib::unrolled>::value) {
+			return "aplib::ulist";
+		}
+		if (std::is_same<backend_t, aplib::counted_tree>::value) {
+			return "aplib::tlist";
+		}
+		return "aplib::list";
+	}
+	void push_back(const type_t &value) { list.push_back(value); }
+	void push_front(const type_t &value) { list.push_front(value); }
+	void insert(size_t index, const type_t &value) { list.insert(index, value); }
+	void erase(size_t index) { list.erase(index); }
+	type_t &at(size_t index) { return list.at(index); }
+	template<typename function_t>
+	void for_each(function_t function)
+	{
+		for (type_t &value : list) {
+			function(value);
+		}
+	}
+	void clear() { list.clear(); }
+};
+
+template<typename type_t>
+class std_list_adapter
+{
+	std::list<type_t, counting_allocator<type_t>> list;
+public:
+	static const char *name() { return "std::list"; }
+	void push_back(const type_t &value) { list.push_back(value); }
+	void push_front(const type_t &value) { list.push_front(value); }
+	void insert(size_t index, const type_t &value)
+	{
+		list.insert(std::next(list.begin(), index), value);
+	}
+	void erase(size_t index) { list.erase(std::next(list.begin(), index)); }
+	type_t &at(size_t index) { return *std::next(list.begin(), index); }
+	template<typename function_t>
+	void for_each(function_t function)
+	{
+		for (type_t &value : list) {
+			function(value);
+		}
+	}
+	void clear() { list.clear(); }
+};
+
+template<typename type_t>
+class std_forward_list_adapter
+{
+	std::forward_list<type_t, counting_allocator<type_t>> list;
+	typename std::forward_list<type_t, counting_allocator<type_t>>::iterator
+	last = list.before_begin();
+public:
+	static const char *name() { return "std::forward_list"; }
+	void push_back(const type_t &value) { last = list.insert_after(last, value); }
+	void push_front(const type_t &value)
+	{
+		if (list.empty()) {
+			last = list.insert_after(list.before_begin(), value);
+			return;
+		}
+		list.push_front(value);
+	}
+	void insert(size_t index, const type_t &value)
+	{
+		auto position = std::next(list.before_begin(), index);
+		auto added = list.insert_after(position, value);
+		if (std::next(added) == list.end()) {
+			last = added;
+		}
+	}
+	void erase(size_t index)
+	{
+		auto position = std::next(list.before_begin(), index);
+		list.erase_after(position);
+		if (std::next(position) == list.end()) {
+			last = position;
+		}
+	}
+	type_t &at(size_t index) { return *std::next(list.begin(), index); }
+	template<typename function_t>
+	void for_each(function_t function)
+	{
+		for (type_t &value : list) {
+			function(value);
+		}
+	}
+	void clear()
+	{
+		list.clear();
+		last = list.before_begin();
+	}
+};
+
+template<typename type_t>
+class std_vector_adapter
+{
+	std::vector<type_t, counting_allocator<type_t>> list;
+public:
+	static const char *name() { return "std::vector"; }
+	void push_back(const type_t &value) { list.push_back(value); }
+	void push_front(const type_t &value) { list.insert(list.begin(), value); }
+	void insert(size_t index, const type_t &value)
+	{
+		list.insert(list.begin() + index, value);
+	}
+	void erase(size_t index) { list.erase(list.begin() + index); }
+	type_t &at(size_t index) { return list[index]; }
+	template<typename function_t>
+	void for_each(function_t function)
+	{
+		for (type_t &value : list) {
+			function(value);
+		}
+	}
+	void clear() { list.clear(); }
+};
+
+// The lists of the multi-threaded cases, they hold keys
+struct concurrent_adapter
+{
+	static const char *name() { return "aplib::concurrent_list"; }
+	aplib::concurrent_list<long> list;
+	struct session_t
+	{
+		aplib::concurrent_list<long>::session session;
+		explicit session_t(concurrent_adapter &adapter) : session(adapter.list.join()) {}
+		void push_front(long key) { session.push_front(key); }
+		bool find(long key)
+		{
+			long found = 0;
+			return session.find_if([key](long value) { return value == key; }, found);
+		}
+		void remove(long key)
+		{
+			session.remove_if([key](long value) { return value == key; });
+		}
+	};
+};
+
+struct mutex_adapter
+{
+	static const char *name() { return "aplib::list+std::mutex"; }
+	aplib::list<long> list;
+	std::mutex mutex;
+	struct session_t
+	{
+		mutex_adapter &adapter;
+		explicit session_t(mutex_adapter &adapter) : adapter(adapter) {}
+		void push_front(long key)
+		{
+			std::lock_guard<std::mutex> lock(adapter.mutex);
+			adapter.list.push_front(key);
+		}
+		bool find(long key)
+		{
+			std::lock_guard<std::mutex> lock(adapter.mutex);
+			return std::find(adapter.list.begin(), adapter.list.end(), key)
+			       != adapter.list.end();
+		}
+		void remove(long key)
+		{
+			std::lock_guard<std::mutex> lock(adapter.mutex);
+			auto found = std::find(adapter.list.begin(), adapter.list.end(), key);
+			if (found != adapter.list.end()) {
+				adapter.list.erase(found);
+			}
+		}
+	};
+};
+
+struct result_t
+{
+	double ns_per_op;
+	double allocations_per_op;
+	long peak_rss_kb;
+};
+
+// Operations that walk the container do fewer of them on large sizes
+static size_t walking_operations(size_t size)
+{
+	size_t operations = 10000000 / (size ? size : 1);
+	if (operations > 1000) {
+		operations = 1000;
+	}
+	if (operations > size) {
+		operations = size;
+	}
+	return operations ? operations : 1;
+}
+
+// Keeps the compiler from removing the work being measured
+static volatile unsigned sink = 0;
+
+template<typename adapter_t, typename type_t>
+static result_t run_case(const std::string &operation, size_t size)
+{
+	using clock = std::chrono::steady_clock;
+	std::mt19937_64 random(size);
+	type_t value {};
+	size_t operations = size;
+	clock::time_point start;
+	clock::time_point stop;
+	adapter_t *adapter = new adapter_t();
+	unsigned sum = 0;
+
+	// Every operation but pushing measures a container of the size
+	if (operation != "push_back" && operation != "push_front") {
+		for (size_t i = 0; i < size; i++) {
+			adapter->push_back(value);
+		}
+	}
+
+	std::vector<size_t> indices;
+	if (operation == "insert" || operation == "erase"
+	    || operation == "random_access") {
+		operations = walking_operations(size);
+		for (size_t i = 0; i < operations; i++) {
+			indices.push_back(random() % (operation == "erase"
+			                              ? size - i : size));
+		}
+	}
+
+	allocations = 0;
+	start = clock::now();
+	if (operation == "push_back") {
+		for (size_t i = 0; i < size; i++) {
+			adapter->push_back(value);
+		}
+	} else if (operation == "push_front") {
+		for (size_t i = 0; i < size; i++) {
+			adapter->push_front(value);
+		}
+	} else if (operation == "insert") {
+		for (size_t index : indices) {
+			adapter->insert(index, value);
+		}
+	} else if (operation == "erase") {
+		for (size_t index : indices) {
+			adapter->erase(index);
+		}
+	} else if (operation == "iterate") {
+		adapter->for_each([&](type_t &element) {
+			sum += element.data[0];
+		});
+	} else if (operation == "random_access") {
+		for (size_t index : indices) {
+			sum += adapter->at(index).data[0];
+		}
+	} else if (operation == "clear") {
+		adapter->clear();
+	} else if (operation == "destroy") {
+		delete adapter;
+		adapter = nullptr;
+	}
+	stop = clock::now();
+	sink = sink + sum;
+	delete adapter;
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	if (operations == 0) {
+		operations = 1;
+	}
+	return result_t {
+		(double) std::chrono::duration_cast<std::chrono::nanoseconds>(
+		        stop - start).count() / operations,
+		(double) allocations / operations,
+		usage.ru_maxrss
+	};
+}
+
+template<typename adapter_t>
+static result_t run_concurrent_case(size_t size, size_t threads)
+{
+	using clock = std::chrono::steady_clock;
+	size_t operations = walking_operations(size) * 10;
+	std::vector<std::thread> workers;
+	clock::time_point start;
+	clock::time_point stop;
+	adapter_t adapter;
+
+	{
+		typename adapter_t::session_t session(adapter);
+		for (size_t i = 0; i < size; i++) {
+			session.push_front((long) i);
+		}
+	}
+
+	start = clock::now();
+	for (size_t t = 0; t < threads; t++) {
+		workers.emplace_back([&adapter, operations, size, t]() {
+			typename adapter_t::session_t session(adapter);
+			std::mt19937_64 random(t);
+			unsigned found = 0;
+
+			for (size_t i = 0; i < operations; i++) {
+				long key = (long) (random() % (size ? size : 1));
+				unsigned kind = random() % 20;
+				if (kind == 0) {
+					session.push_front(key);
+				} else if (kind == 1) {
+					session.remove(key);
+				} else {
+					found += session.find(key);
+				}
+			}
+			sink = sink + found;
+		});
+	}
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+	stop = clock::now();
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	return result_t {
+		(double) std::chrono::duration_cast<std::chrono::nanoseconds>(
+		        stop - start).count() / (operations * threads),
+		0,
+		usage.ru_maxrss
+	};
+}
+
+struct options_t
+{
+	std::vector<size_t> sizes {10, 1000, 100000, 1000000, 10000000};
+	std::vector<size_t> payloads {4, 64, 256};
+	std::vector<size_t> threads {1, 2, 4, 8};
+	bool json = false;
+	bool first = true;
+};
+
+template<typename case_t>
+static void report(options_t &options, const char *name, const std::string &operation,
+                   size_t size, size_t payload, size_t threads, case_t run_case)
+{
+	int pipes[2];
+	result_t result {};
+	pid_t child = 0;
+
+	// The case runs in a child so that the peak RSS is only its own
+	if (pipe(pipes)) {
+		return;
+	}
+	child = fork();
+	if (child == 0) {
+		close(pipes[0]);
+		result = run_case();
+		if (write(pipes[1], &result, sizeof(result)) != sizeof(result)) {
+			_exit(1);
+		}
+		_exit(0);
+	}
+	close(pipes[1]);
+	if (child < 0 || read(pipes[0], &result, sizeof(result)) != sizeof(result)) {
+		close(pipes[0]);
+		waitpid(child, nullptr, 0);
+		return;
+	}
+	close(pipes[0]);
+	waitpid(child, nullptr, 0);
+
+	if (options.json) {
+		printf("%s\n  {\"container\": \"%s\", \"operation\": \"%s\", "
+		       "\"size\": %zu, \"payload\": %zu, \"threads\": %zu, "
+		       "\"ns_per_op\": %.2f, \"allocations_per_op\": %.3f, "
+		       "\"peak_rss_kb\": %ld}",
+		       options.first ? "" : ",", name, operation.c_str(), size,
+		       payload, threads, result.ns_per_op, result.allocations_per_op,
+		       result.peak_rss_kb);
+	} else {
+		printf("%s,%s,%zu,%zu,%zu,%.2f,%.3f,%ld\n", name, operation.c_str(),
+		       size, payload, threads, result.ns_per_op,
+		       result.allocations_per_op, result.peak_rss_kb);
+	}
+	options.first = false;
+	fflush(stdout);
+}
+
+template<typename adapter_t, typename type_t>
+static void run(options_t &options, size_t payload,
+                const std::string &operation, size_t size)
+{
+	// Pushing to the front of a vector is quadratic
+	if (std::is_same<adapter_t, std_vector_adapter<type_t>>::value
+	    && operation == "push_front" && size > 10000) {
+		return;
+	}
+
+	report(options, adapter_t::name(), operation, size, payload, 1, [&]() {
+		return run_case<adapter_t, type_t>(operation, size);
+	});
+}
+
+template<typename adapter_t>
+static void run_concurrent(options_t &options, size_t size, size_t threads)
+{
+	report(options, adapter_t::name(), "read_mostly", size, sizeof(long),
+	       threads, [&]() {
+		return run_concurrent_case<adapter_t>(size, threads);
+	});
+}
+
+template<typename type_t>
+static void run_payload(options_t &options, size_t payload)
+{
+	static const char *operations[] = {
+		"push_back", "push_front", "insert", "erase", "iterate",
+		"random_access", "clear", "destroy"
+	};
+
+	for (size_t size : options.sizes) {
+		for (const char *operation : operations) {
+			run<c_list_adapter<type_t>, type_t>(options, payload, operation, size);
+			run<c_split_list_adapter<type_t>, type_t>(options, payload, operation, size);
+			run<c_dlist_adapter<type_t>, type_t>(options, payload, operation, size);
+			run<c_ulist_adapter<type_t>, type_t>(options, payload, operation, size);
+			run<c_skiplist_adapter<type_t>, type_t>(options, payload, operation, size);
+			run<aplib_adapter<type_t, aplib::singly_linked>, type_t>(
+			        options, payload, operation, size);
+			run<aplib_adapter<type_t, aplib::doubly_linked>, type_t>(
+			        options, payload, operation, size);
+			run<aplib_adapter<type_t, aplib::unrolled>, type_t>(
+			        options, payload, operation, size);
+			run<aplib_adapter<type_t, aplib::counted_tree>, type_t>(
+			        options, payload, operation, size);
+			run<std_list_adapter<type_t>, type_t>(options, payload, operation, size);
+			run<std_forward_list_adapter<type_t>, type_t>(
+			        options, payload, operation, size);
+			run<std_vector_adapter<type_t>, type_t>(options, payload, operation, size);
+		}
+	}
+}
+
+static std::vector<size_t> parse_list(const char *text)
+{
+	std::vector<size_t> values;
+	char *end = nullptr;
+
+	while (*text) {
+		values.push_back(strtoull(text, &end, 10));
+		text = (*end == ',') ? end + 1 : end;
+		if (end == text && *text) {
+			break;
+		}
+	}
+	return values;
+}
+
+int main(int argc, char **argv)
+{
+	options_t options;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--sizes") && i + 1 < argc) {
+			options.sizes = parse_list(argv[++i]);
+		} else if (!strcmp(argv[i], "--payloads") && i + 1 < argc) {
+			options.payloads = parse_list(argv[++i]);
+		} else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+			options.threads = parse_list(argv[++i]);
+		} else if (!strcmp(argv[i], "--format") && i + 1 < argc) {
+			options.json = !strcmp(argv[++i], "json");
+		} else {
+			fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	if (options.json) {
+		printf("[");
+	} else {
+		printf("container,operation,size,payload,threads,ns_per_op,"
+		       "allocations_per_op,peak_rss_kb\n");
+	}
+
+	for (size_t payload : options.payloads) {
+		switch (payload) {
+		case 4:
+			run_payload<payload_t<4>>(options, payload);
+			break;
+		case 64:
+			run_payload<payload_t<64>>(options, payload);
+			break;
+		case 256:
+			run_payload<payload_t<256>>(options, payload);
+			break;
+		default:
+			fprintf(stderr, "Unsupported payload: %zu\n", payload);
+			return 1;
+		}
+	}
+
+	for (size_t size : options.sizes) {
+		for (size_t threads : options.threads) {
+			if (!threads) {
+				continue;
+			}
+			run_concurrent<concurrent_adapter>(options, size, threads);
+			run_concurrent<mutex_adapter>(options, size, threads);
+		}
+	}
+
+	if (options.json) {
+		printf("\n]\n");
+	}
+	return 0;
+}
@@ -0,0 +1,648 @@
+/*
+ * Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * A Minimal C Doubly Linked List
+ *   Usage and other information is provided in the README.md file from the
+ *   repository. Please refer to that to know how to use this library.
+ */
+
+#ifndef DLIST_H
+#define DLIST_H "dlist.h"
+
+/* The doubly linked list uses the allocators of the list */
+#include "list.h"
+
+/* Implement the list code by defining
+ * LIST_IMPL before including this library */
+
+/* The data of an element is allocated together with the element,
+ * in the same way as the elements of the singly linked list */
+struct delement_t {
+	void *data;
+	void *next;
+	void *prev;
+};
+
+struct dlist_t {
+	/* The base does not contain an element, the list is circular
+	 * through it. The next of the base is the index of 0, and the
+	 * previous of the base is the last element of the list */
+	struct delement_t *base;
+	/* The last accessed element and its index, walking starts from
+	 * the closest of it, the first and the last element */
+	struct delement_t *cursor;
+	size_t cursor_index;
+	size_t size;
+	size_t typesize;
+	/* Elements are allocated using malloc if there is no allocate */
+	struct list_allocator_t allocator;
+};
+
+
+struct dlist_t *create_dlist(size_t typesize);
+/* The allocator is copied into the list, the elements are
+ * allocated using malloc if the allocator is NULL */
+struct dlist_t *create_dlist_with_allocator(size_t typesize,
+                                            const struct list_allocator_t *allocator);
+
+/* The index of -1 and the size of the list both give the base */
+struct delement_t *get_delement(size_t index, struct dlist_t *list);
+size_t get_dlist_size(struct dlist_t *list);
+
+/* Define LIST_DEBUG to check the size, the last
+ * accessed element and links of a list */
+#ifdef LIST_DEBUG
+int dlist_verify(struct dlist_t *list);
+#endif
+
+/* These functions are not supposed to be used externally */
+struct delement_t *create_delement(struct dlist_t *list);
+int delete_delement(struct delement_t *element, struct dlist_t *list);
+
+/* You can add element at the end of the list by giving it the size
+ * of the list, adding or removing at either end does not walk */
+struct delement_t *add_delement(size_t index, struct dlist_t *list);
+int remove_delement(size_t index, struct dlist_t *list);
+
+/* Add an element before the given element, or at the end if it is the
+ * base, and remove the given element. Neither of them walk the list */
+struct delement_t *insert_delement(struct delement_t *next, struct dlist_t *list);
+int erase_delement(struct delement_t *element, struct dlist_t *list);
+/* Moves the element before the next element, or to the end if it is the
+ * base, without walking or allocating. The element of the data of an
+ * element is found without walking as well */
+int move_delement(struct delement_t *element, struct delement_t *next,
+                  struct dlist_t *list);
+struct delement_t *get_data_delement(void *data, struct dlist_t *list);
+
+/* Moves all the elements of the other list to the index of the list like
+ * splice_list, and the elements from the index to the end into a new list */
+int splice_dlist(size_t index, struct dlist_t *other, struct dlist_t *list);
+struct dlist_t *split_dlist(size_t index, struct dlist_t *list);
+
+/* Sorts the list like sort_list, the previous links are set after */
+int sort_dlist(int (*compare)(const void *, const void *), struct dlist_t *list);
+int sort_dlist_with_context(int (*compare)(const void *, const void *, void *),
+                            void *context, struct dlist_t *list);
+
+int clear_dlist(struct dlist_t *list);
+int delete_dlist(struct dlist_t *list);
+
+#ifdef LIST_IMPL
+
+struct dlist_t *create_dlist(size_t typesize)
+{
+	return create_dlist_with_allocator(typesize, NULL);
+}
+
+struct dlist_t *create_dlist_with_allocator(size_t typesize,
+                                            const struct list_allocator_t *allocator)
+{
+	struct dlist_t *list = (struct dlist_t *) malloc(sizeof(struct dlist_t));
+
+	if (!list) {
+		return NULL;
+	}
+
+	list->cursor = NULL;
+	list->cursor_index = 0;
+	list->size = 0;
+	list->typesize = typesize;
+	list->allocator.allocate = NULL;
+	list->allocator.deallocate = NULL;
+	list->allocator.release = NULL;
+	list->allocator.context = NULL;
+	if (allocator) {
+		list->allocator = *allocator;
+	}
+	list->base = (struct delement_t *) malloc(sizeof(struct delement_t));
+
+	if (!list->base) {
+		free(list);
+		return NULL;
+	}
+
+	list->base->data = NULL;
+	list->base->next = (void *) list->base;
+	list->base->prev = (void *) list->base;
+	return list;
+}
+
+struct delement_t *get_delement(size_t index, struct dlist_t *list)
+{
+	struct delement_t *element = NULL;
+	size_t position = 0;
+	size_t distance = 0;
+	size_t cursor_distance = 0;
+
+	if (!list) {
+		return NULL;
+	}
+	if (index == (size_t) -1 || index == list->size) {
+		return list->base;
+	}
+	if (index > list->size) {
+		return NULL;
+	}
+
+	/* Start from the closest of the first, the last
+	 * and the last accessed element to the index */
+	if (index < list->size - index) {
+		element = (struct delement_t *) list->base->next;
+		position = 0;
+		distance = index;
+	} else {
+		element = (struct delement_t *) list->base->prev;
+		position = list->size - 1;
+		distance = position - index;
+	}
+	if (list->cursor) {
+		cursor_distance = (list->cursor_index > index)
+		                  ? list->cursor_index - index
+		                  : index - list->cursor_index;
+		if (cursor_distance < distance) {
+			element = list->cursor;
+			position = list->cursor_index;
+		}
+	}
+
+	for (; position < index; position++) {
+		element = (struct delement_t *) element->next;
+	}
+	for (; position > index; position--) {
+		element = (struct delement_t *) element->prev;
+	}
+
+	list->cursor = element;
+	list->cursor_index = index;
+	return element;
+}
+
+size_t get_dlist_size(struct dlist_t *list)
+{
+	if (!list) {
+		return 0;
+	}
+	return list->size;
+}
+
+#ifdef LIST_DEBUG
+int dlist_verify(struct dlist_t *list)
+{
+	struct delement_t *element = NULL;
+	size_t size = 0;
+	int cursor_found = 0;
+
+	if (!list) {
+		return 1;
+	}
+	if (!list->base) {
+		return 2;
+	}
+	element = list->base;
+
+	/* Stop after the size is exceeded, in case the links are broken */
+	while (element->next != (void *) list->base && size <= list->size) {
+		if (((struct delement_t *) element->next)->prev != (void *) element) {
+			return 3;
+		}
+		element = (struct delement_t *) element->next;
+		if (!element->data) {
+			return 4;
+		}
+		if (element == list->cursor) {
+			if (list->cursor_index != size) {
+				return 5;
+			}
+			cursor_found = 1;
+		}
+		size++;
+	}
+
+	if (size != list->size) {
+		return 6;
+	}
+	if (list->base->prev != (void *) element) {
+		return 7;
+	}
+	if (list->cursor && !cursor_found) {
+		return 5;
+	}
+	return 0;
+}
+#endif
+
+
+
+struct delement_t *create_delement(struct dlist_t *list)
+{
+	struct delement_t *element = NULL;
+	size_t offset = 0;
+
+	if (!list) {
+		return NULL;
+	}
+
+	offset = align_data_offset(sizeof(struct delement_t), list->typesize);
+	if (list->allocator.allocate) {
+		element = (struct delement_t *) list->allocator.allocate(
+		                  list->allocator.context, offset + list->typesize);
+	} else {
+		element = (struct delement_t *) malloc(offset + list->typesize);
+	}
+	if (!element) {
+		return NULL;
+	}
+
+	element->next = NULL;
+	element->prev = NULL;
+	element->data = (void *) ((char *) element + offset);
+	return element;
+}
+
+int delete_delement(struct delement_t *element, struct dlist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (!element) {
+		return 1;
+	}
+	if (!element->data) {
+		return 2;
+	}
+
+	/* The data is freed along with the element */
+	if (list->allocator.deallocate) {
+		list->allocator.deallocate(list->allocator.context, element,
+		                           align_data_offset(sizeof(struct delement_t),
+		                                             list->typesize) + list->typesize);
+	} else {
+		free(element);
+	}
+	return 0;
+}
+
+
+
+struct delement_t *add_delement(size_t index, struct dlist_t *list)
+{
+	struct delement_t *next = NULL;
+	struct delement_t *new_element = NULL;
+
+	if (!list) {
+		return NULL;
+	}
+	if (index > list->size) {
+		return NULL;
+	}
+
+	/* Adding at the end gets the base, no walking is done */
+	next = get_delement(index, list);
+	if (!next) {
+		return NULL;
+	}
+
+	new_element = insert_delement(next, list);
+	if (!new_element) {
+		return NULL;
+	}
+
+	/* The elements after the index have moved, so
+	 * the new element becomes the last accessed */
+	list->cursor = new_element;
+	list->cursor_index = index;
+	return new_element;
+}
+
+int remove_delement(size_t index, struct dlist_t *list)
+{
+	struct delement_t *element = NULL;
+	struct delement_t *prev = NULL;
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+	if (index >= list->size) {
+		return 3;
+	}
+
+	element = get_delement(index, list);
+	if (!element) {
+		return 4;
+	}
+	prev = (struct delement_t *) element->prev;
+
+	error = erase_delement(element, list);
+	if (error) {
+		return error;
+	}
+
+	/* The previous element keeps its index, the base is not cached */
+	list->cursor = (prev == list->base) ? NULL : prev;
+	list->cursor_index = index - 1;
+	return 0;
+}
+
+struct delement_t *insert_delement(struct delement_t *next, struct dlist_t *list)
+{
+	struct delement_t *new_element = NULL;
+	struct delement_t *prev = NULL;
+
+	if (!list) {
+		return NULL;
+	}
+	if (!next) {
+		return NULL;
+	}
+
+	new_element = create_delement(list);
+	if (!new_element) {
+		return NULL;
+	}
+
+	prev = (struct delement_t *) next->prev;
+	new_element->next = (void *) next;
+	new_element->prev = (void *) prev;
+	prev->next = (void *) new_element;
+	next->prev = (void *) new_element;
+
+	/* The index of the last accessed element is not known anymore */
+	list->cursor = NULL;
+	list->size++;
+	return new_element;
+}
+
+int erase_delement(struct delement_t *element, struct dlist_t *list)
+{
+	struct delement_t *prev = NULL;
+	struct delement_t *next = NULL;
+
+	if (!list) {
+		return 1;
+	}
+	if (!element || element == list->base) {
+		return 4;
+	}
+
+	prev = (struct delement_t *) element->prev;
+	next = (struct delement_t *) element->next;
+	prev->next = (void *) next;
+	next->prev = (void *) prev;
+
+	/* The index of the last accessed element is not known anymore */
+	list->cursor = NULL;
+	if (delete_delement(element, list)) {
+		return 6;
+	}
+	list->size--;
+
+	return 0;
+}
+
+int move_delement(struct delement_t *element, struct delement_t *next,
+                  struct dlist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (!element || !next || element == list->base) {
+		return 4;
+	}
+	if (element == next || element->next == (void *) next) {
+		return 0;
+	}
+
+	((struct delement_t *) element->prev)->next = element->next;
+	((struct delement_t *) element->next)->prev = element->prev;
+	element->next = (void *) next;
+	element->prev = next->prev;
+	((struct delement_t *) next->prev)->next = (void *) element;
+	next->prev = (void *) element;
+
+	list->cursor = NULL;
+	return 0;
+}
+
+struct delement_t *get_data_delement(void *data, struct dlist_t *list)
+{
+	if (!list || !data) {
+		return NULL;
+	}
+
+	/* The data is placed at the same offset in every element */
+	return (struct delement_t *) ((char *) data
+	                              - align_data_offset(sizeof(struct delement_t),
+	                                                  list->typesize));
+}
+
+int splice_dlist(size_t index, struct dlist_t *other, struct dlist_t *list)
+{
+	struct delement_t *next = NULL;
+	struct delement_t *first = NULL;
+	struct delement_t *last = NULL;
+
+	if (!list || !other) {
+		return 1;
+	}
+	if (index > list->size) {
+		return 3;
+	}
+	if (other == list || other->typesize != list->typesize
+	    || other->allocator.allocate != list->allocator.allocate
+	    || other->allocator.deallocate != list->allocator.deallocate
+	    || other->allocator.release || list->allocator.release) {
+		return 2;
+	}
+	if (other->size == 0) {
+		return 0;
+	}
+
+	next = get_delement(index, list);
+	if (!next) {
+		return 4;
+	}
+	first = (struct delement_t *) other->base->next;
+	last = (struct delement_t *) other->base->prev;
+
+	first->prev = next->prev;
+	last->next = (void *) next;
+	((struct delement_t *) next->prev)->next = (void *) first;
+	next->prev = (void *) last;
+
+	list->cursor = last;
+	list->cursor_index = index + other->size - 1;
+	list->size += other->size;
+
+	other->base->next = (void *) other->base;
+	other->base->prev = (void *) other->base;
+	other->cursor = NULL;
+	other->cursor_index = 0;
+	other->size = 0;
+	return 0;
+}
+
+struct dlist_t *split_dlist(size_t index, struct dlist_t *list)
+{
+	struct dlist_t *split = NULL;
+	struct delement_t *first = NULL;
+	struct delement_t *last = NULL;
+
+	if (!list) {
+		return NULL;
+	}
+	if (index > list->size || list->allocator.release) {
+		return NULL;
+	}
+
+	first = get_delement(index, list);
+	if (!first) {
+		return NULL;
+	}
+	split = create_dlist_with_allocator(list->typesize,
+	                                    list->allocator.allocate ? &list->allocator : NULL);
+	if (!split) {
+		return NULL;
+	}
+
+	/* Nothing is moved when splitting at the end */
+	if (index < list->size) {
+		last = (struct delement_t *) list->base->prev;
+		list->base->prev = first->prev;
+		((struct delement_t *) first->prev)->next = (void *) list->base;
+
+		first->prev = (void *) split->base;
+		last->next = (void *) split->base;
+		split->base->next = (void *) first;
+		split->base->prev = (void *) last;
+		split->size = list->size - index;
+		list->size = index;
+	}
+
+	list->cursor = NULL;
+	list->cursor_index = 0;
+	return split;
+}
+
+int sort_dlist(int (*compare)(const void *, const void *), struct dlist_t *list)
+{
+	if (!compare) {
+		return 1;
+	}
+	return sort_dlist_with_context(compare_list_data, (void *) &compare, list);
+}
+
+int sort_dlist_with_context(int (*compare)(const void *, const void *, void *),
+                            void *context, struct dlist_t *list)
+{
+	struct delement_t *element = NULL;
+	struct delement_t *prev = NULL;
+	void *last = NULL;
+
+	if (!list || !compare) {
+		return 1;
+	}
+	if (list->size < 2) {
+		return 0;
+	}
+
+	/* The elements are sorted as a singly linked list ending in NULL */
+	((struct delement_t *) list->base->prev)->next = NULL;
+	list->base->next = sort_list_elements(list->base->next,
+	                                      offsetof(struct delement_t, next),
+	                                      compare, context, &last);
+
+	prev = list->base;
+	for (element = (struct delement_t *) list->base->next; element;
+	     element = (struct delement_t *) element->next) {
+		element->prev = (void *) prev;
+		prev = element;
+	}
+	prev->next = (void *) list->base;
+	list->base->prev = (void *) prev;
+
+	list->cursor = NULL;
+	list->cursor_index = 0;
+	return 0;
+}
+
+
+
+int clear_dlist(struct dlist_t *list)
+{
+	struct delement_t *element = NULL;
+	struct delement_t *next = NULL;
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+	if (list->size == 0) {
+		/* This is not considered an error */
+		return 0;
+	}
+
+	/* The allocator can free all the elements at once,
+	 * otherwise every element is deleted in a single pass */
+	if (list->allocator.release) {
+		list->allocator.release(list->allocator.context);
+	} else {
+		element = (struct delement_t *) list->base->next;
+		while (element != list->base) {
+			next = (struct delement_t *) element->next;
+			if (delete_delement(element, list)) {
+				error = 2;
+			}
+			element = next;
+		}
+	}
+
+	list->base->next = (void *) list->base;
+	list->base->prev = (void *) list->base;
+	list->cursor = NULL;
+	list->cursor_index = 0;
+	list->size = 0;
+	return error;
+}
+
+int delete_dlist(struct dlist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (clear_dlist(list)) {
+		return 2;
+	}
+	if (!list->base) {
+		return 3;
+	}
+
+	free(list->base);
+	free(list);
+	return 0;
+}
+
+/* LIST_IMPL */
+#endif
+
+/* DLIST_H */
+#endif
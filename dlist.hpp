@@ -0,0 +1,245 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// The doubly linked backend for the C++ Wrapper of the Minimal C Linked List
+//   Usage and other information is provided in the README.md file from the
+//   repository. Please refer to that to know how to use this library.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DLIST_HPP
+#define DLIST_HPP "dlist.hpp"
+
+// This header is just a wrapper for the Minimal C Doubly Linked List
+#include "dlist.h"
+#include "list.hpp"
+
+namespace aplib
+{
+// The doubly linked backend adds and removes at both ends and at
+// iterators without walking, and its iterators can move back
+struct doubly_linked
+{
+	using internal_t = dlist_t;
+	using position_t = delement_t *;
+	using iterator_category = std::bidirectional_iterator_tag;
+	static constexpr bool moves_elements = false;
+
+	static internal_t *create(size_t typesize,
+	                          const list_allocator_t *allocator);
+	static int destroy(internal_t *list);
+	static int clear(internal_t *list);
+	static size_t size(internal_t *list);
+
+	static void *get(size_t index, internal_t *list);
+	static void *add(size_t index, internal_t *list);
+	static int remove(size_t index, internal_t *list);
+	static int remove(size_t index, size_t count, internal_t *list);
+
+	static position_t begin(internal_t *list);
+	static position_t end(internal_t *list);
+	static position_t next(position_t position);
+	static position_t prev(position_t position);
+	static void *data(position_t position);
+
+	static position_t insert(position_t position, internal_t *list);
+	static position_t erase(position_t position, internal_t *list);
+
+	static int splice(size_t index, internal_t *other, internal_t *list);
+	static internal_t *split(size_t index, internal_t *list);
+	static int sort(int (*compare)(const void *, const void *, void *),
+	                void *context, internal_t *list);
+	static int unique(int (*compare)(const void *, const void *, void *),
+	                  void *context, internal_t *list);
+
+	static position_t find(size_t index, internal_t *list);
+};
+
+template<typename type_t, typename alloc_t = std::allocator<type_t>>
+using dlist = list<type_t, alloc_t, doubly_linked>;
+}
+
+#ifdef LIST_IMPL
+
+aplib::doubly_linked::internal_t *aplib::doubly_linked::create(size_t typesize,
+        const list_allocator_t *allocator)
+{
+	return create_dlist_with_allocator(typesize, allocator);
+}
+
+int aplib::doubly_linked::destroy(internal_t *list)
+{
+	return delete_dlist(list);
+}
+
+int aplib::doubly_linked::clear(internal_t *list)
+{
+	return clear_dlist(list);
+}
+
+size_t aplib::doubly_linked::size(internal_t *list)
+{
+	return get_dlist_size(list);
+}
+
+void *aplib::doubly_linked::get(size_t index, internal_t *list)
+{
+	// The base is only given for the index of -1 and the size
+	if (!list || index >= list->size) {
+		return nullptr;
+	}
+	return get_delement(index, list)->data;
+}
+
+void *aplib::doubly_linked::add(size_t index, internal_t *list)
+{
+	delement_t *element = add_delement(index, list);
+	return element ? element->data : nullptr;
+}
+
+int aplib::doubly_linked::remove(size_t index, internal_t *list)
+{
+	return remove_delement(index, list);
+}
+
+int aplib::doubly_linked::remove(size_t index, size_t count, internal_t *list)
+{
+	delement_t *element = nullptr;
+	delement_t *next = nullptr;
+
+	if (!list) {
+		return 1;
+	}
+	if (count == 0) {
+		return 0;
+	}
+	if (index >= list->size || count > list->size - index) {
+		return 3;
+	}
+
+	// Erasing an element does not walk, only finding the first one does
+	element = get_delement(index, list);
+	for (; count > 0; count--) {
+		next = (delement_t *) element->next;
+		if (erase_delement(element, list)) {
+			return 2;
+		}
+		element = next;
+	}
+	return 0;
+}
+
+aplib::doubly_linked::position_t aplib::doubly_linked::begin(internal_t *list)
+{
+	return (delement_t *) list->base->next;
+}
+
+aplib::doubly_linked::position_t aplib::doubly_linked::end(internal_t *list)
+{
+	return list->base;
+}
+
+aplib::doubly_linked::position_t aplib::doubly_linked::next(position_t position)
+{
+	return (delement_t *) position->next;
+}
+
+aplib::doubly_linked::position_t aplib::doubly_linked::prev(position_t position)
+{
+	return (delement_t *) position->prev;
+}
+
+void *aplib::doubly_linked::data(position_t position)
+{
+	return position->data;
+}
+
+aplib::doubly_linked::position_t aplib::doubly_linked::insert(position_t position,
+        internal_t *list)
+{
+	delement_t *element = insert_delement(position, list);
+	return element ? element : list->base;
+}
+
+aplib::doubly_linked::position_t aplib::doubly_linked::erase(position_t position,
+        internal_t *list)
+{
+	delement_t *next = (delement_t *) position->next;
+
+	erase_delement(position, list);
+	return next;
+}
+
+int aplib::doubly_linked::splice(size_t index, internal_t *other,
+                                 internal_t *list)
+{
+	return splice_dlist(index, other, list);
+}
+
+aplib::doubly_linked::internal_t *aplib::doubly_linked::split(size_t index,
+        internal_t *list)
+{
+	return split_dlist(index, list);
+}
+
+int aplib::doubly_linked::sort(int (*compare)(const void *, const void *, void *),
+                               void *context, internal_t *list)
+{
+	return sort_dlist_with_context(compare, context, list);
+}
+
+int aplib::doubly_linked::unique(int (*compare)(const void *, const void *, void *),
+                                 void *context, internal_t *list)
+{
+	delement_t *element = (delement_t *) list->base->next;
+	delement_t *next = nullptr;
+
+	if (list->size < 2) {
+		return 0;
+	}
+
+	// The elements equal to the one kept are erased without walking
+	while ((next = (delement_t *) element->next) != list->base) {
+		if (compare(element->data, next->data, context) == 0) {
+			if (erase_delement(next, list)) {
+				return 2;
+			}
+		} else {
+			element = next;
+		}
+	}
+	return 0;
+}
+
+aplib::doubly_linked::position_t aplib::doubly_linked::find(size_t index,
+        internal_t *list)
+{
+	// The size gives the base, which is the end
+	if (index >= list->size) {
+		return list->base;
+	}
+	return get_delement(index, list);
+}
+
+// LIST_IMPL
+#endif
+
+// DLIST_HPP
+#endif
@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Indexed list with a hash index of the Minimal C Linked List
+ *   Usage and other information is provided in the README.md file from the
+ *   repository. Please refer to that to know how to use this library.
+ */
+
+#ifndef ILIST_H
+#define ILIST_H "ilist.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* The elements of an indexed list are kept in a doubly linked list */
+#include "dlist.h"
+
+/* Implement the list code by defining
+ * LIST_IMPL before including this library */
+
+/* A list index finds the elements of a list by a key in the data of the
+ * elements. It works for the elements of a list and a doubly linked list,
+ * the key is found using the data pointer at the start of the elements.
+ * The index is a table of slots using open addressing, and the elements
+ * far from their slot take the place of the ones closer to their slot
+ * (Robin Hood hashing), so finding a key stops early. Removing moves the
+ * next elements back instead of leaving a mark in the slot */
+struct list_index_slot_t {
+	/* The mixed hash of the key, and NULL if the slot is empty */
+	size_t hash;
+	void *element;
+};
+
+struct list_index_t {
+	struct list_index_slot_t *slots;
+	/* The number of slots is a power of two, or zero */
+	size_t capacity;
+	size_t count;
+	/* Gives the key in the data, the hash of a key and compares two
+	 * keys like qsort, the keys are equal when it gives 0 */
+	const void *(*key)(const void *data);
+	size_t (*hash)(const void *key);
+	int (*compare)(const void *, const void *);
+};
+
+/* An indexed list is a doubly linked list and an index of its elements,
+ * where every key is in the list at most once. It is an ordered map, or
+ * an LRU cache when the used elements are moved to the front */
+struct ilist_t {
+	/* Walk and access the elements using the functions of the doubly
+	 * linked list, and add and remove them using the ones of this list.
+	 * move_delement changes the order without changing the index */
+	struct dlist_t *list;
+	struct list_index_t *index;
+};
+
+/* The slots are grown to keep at most LIST_INDEX_LOAD out of 8 in use */
+#ifndef LIST_INDEX_LOAD
+#define LIST_INDEX_LOAD 6
+#endif
+
+
+struct list_index_t *create_list_index(const void *(*key)(const void *),
+                                       size_t (*hash)(const void *),
+                                       int (*compare)(const void *, const void *));
+/* Gives the element with the key, or NULL if there is none */
+void *find_list_index(const void *key, struct list_index_t *index);
+/* Adds the element, 2 is returned if the key is in the index already */
+int insert_list_index(void *element, struct list_index_t *index);
+/* Removes the element, 3 is returned if it is not in the index */
+int erase_list_index(void *element, struct list_index_t *index);
+/* Makes room for a number of elements, so that inserting them does not
+ * allocate */
+int reserve_list_index(size_t count, struct list_index_t *index);
+int clear_list_index(struct list_index_t *index);
+int delete_list_index(struct list_index_t *index);
+
+struct ilist_t *create_ilist(size_t typesize, const void *(*key)(const void *),
+                             size_t (*hash)(const void *),
+                             int (*compare)(const void *, const void *));
+/* The allocator is used for the elements, the index uses malloc */
+struct ilist_t *create_ilist_with_allocator(size_t typesize,
+                                            const void *(*key)(const void *),
+                                            size_t (*hash)(const void *),
+                                            int (*compare)(const void *, const void *),
+                                            const struct list_allocator_t *allocator);
+struct delement_t *find_ielement(const void *key, struct ilist_t *list);
+size_t get_ilist_size(struct ilist_t *list);
+
+/* Define LIST_DEBUG to check the list and
+ * that every element is in the index */
+#ifdef LIST_DEBUG
+int ilist_verify(struct ilist_t *list);
+#endif
+
+/* The data is copied into the added element. NULL is returned if an
+ * element with the same key is in the list, or if allocating fails */
+struct delement_t *add_ielement(size_t index, const void *data, struct ilist_t *list);
+struct delement_t *insert_ielement(struct delement_t *next, const void *data,
+                                   struct ilist_t *list);
+int remove_ielement(size_t index, struct ilist_t *list);
+int erase_ielement(struct delement_t *element, struct ilist_t *list);
+
+int clear_ilist(struct ilist_t *list);
+int delete_ilist(struct ilist_t *list);
+
+/* These functions are not supposed to be used externally */
+size_t mix_list_hash(size_t hash);
+size_t find_list_index_slot(const void *key, size_t hash, struct list_index_t *index);
+void place_list_index_slot(size_t hash, void *element, struct list_index_t *index);
+struct delement_t *add_ielement_before(struct delement_t *next, size_t index,
+                                       const void *data, struct ilist_t *list);
+
+#ifdef LIST_IMPL
+
+struct list_index_t *create_list_index(const void *(*key)(const void *),
+                                       size_t (*hash)(const void *),
+                                       int (*compare)(const void *, const void *))
+{
+	struct list_index_t *index = NULL;
+
+	if (!key || !hash || !compare) {
+		return NULL;
+	}
+	index = (struct list_index_t *) malloc(sizeof(struct list_index_t));
+	if (!index) {
+		return NULL;
+	}
+
+	index->slots = NULL;
+	index->capacity = 0;
+	index->count = 0;
+	index->key = key;
+	index->hash = hash;
+	index->compare = compare;
+	return index;
+}
+
+void *find_list_index(const void *key, struct list_index_t *index)
+{
+	size_t slot = 0;
+
+	if (!index || !key) {
+		return NULL;
+	}
+
+	slot = find_list_index_slot(key, mix_list_hash(index->hash(key)), index);
+	if (slot == index->capacity) {
+		return NULL;
+	}
+	return index->slots[slot].element;
+}
+
+int insert_list_index(void *element, struct list_index_t *index)
+{
+	const void *key = NULL;
+	size_t hash = 0;
+
+	if (!index || !element) {
+		return 1;
+	}
+
+	key = index->key(*(void **) element);
+	hash = mix_list_hash(index->hash(key));
+	if (find_list_index_slot(key, hash, index) != index->capacity) {
+		return 2;
+	}
+	if (reserve_list_index(index->count + 1, index)) {
+		return 4;
+	}
+
+	place_list_index_slot(hash, element, index);
+	index->count++;
+	return 0;
+}
+
+int erase_list_index(void *element, struct list_index_t *index)
+{
+	const void *key = NULL;
+	size_t mask = 0;
+	size_t slot = 0;
+	size_t next = 0;
+
+	if (!index || !element) {
+		return 1;
+	}
+
+	key = index->key(*(void **) element);
+	slot = find_list_index_slot(key, mix_list_hash(index->hash(key)), index);
+	if (slot == index->capacity || index->slots[slot].element != element) {
+		return 3;
+	}
+
+	/* The elements after the slot are moved back one slot, until one is
+	 * in its own slot or the slot is empty */
+	mask = index->capacity - 1;
+	next = (slot + 1) & mask;
+	while (index->slots[next].element
+	       && ((next - index->slots[next].hash) & mask) != 0) {
+		index->slots[slot] = index->slots[next];
+		slot = next;
+		next = (next + 1) & mask;
+	}
+	index->slots[slot].element = NULL;
+	index->count--;
+	return 0;
+}
+
+int reserve_list_index(size_t count, struct list_index_t *index)
+{
+	struct list_index_slot_t *slots = NULL;
+	size_t previous = 0;
+	size_t capacity = 0;
+	size_t i = 0;
+
+	if (!index) {
+		return 1;
+	}
+
+	capacity = index->capacity ? index->capacity : 16;
+	while (count > capacity / 8 * LIST_INDEX_LOAD) {
+		if (capacity > (size_t) -1 / 2 / sizeof(struct list_index_slot_t)) {
+			return 4;
+		}
+		capacity *= 2;
+	}
+	if (capacity == index->capacity) {
+		return 0;
+	}
+
+	slots = index->slots;
+	index->slots = (struct list_index_slot_t *) calloc(capacity,
+	               sizeof(struct list_index_slot_t));
+	if (!index->slots) {
+		index->slots = slots;
+		return 4;
+	}
+
+	/* The elements are placed again using more bits of their hash */
+	previous = index->capacity;
+	index->capacity = capacity;
+	for (i = 0; i < previous; i++) {
+		if (slots[i].element) {
+			place_list_index_slot(slots[i].hash, slots[i].element, index);
+		}
+	}
+	free(slots);
+	return 0;
+}
+
+int clear_list_index(struct list_index_t *index)
+{
+	if (!index) {
+		return 1;
+	}
+
+	if (index->slots) {
+		memset(index->slots, 0, index->capacity * sizeof(struct list_index_slot_t));
+	}
+	index->count = 0;
+	return 0;
+}
+
+int delete_list_index(struct list_index_t *index)
+{
+	if (!index) {
+		return 1;
+	}
+
+	free(index->slots);
+	free(index);
+	return 0;
+}
+
+struct ilist_t *create_ilist(size_t typesize, const void *(*key)(const void *),
+                             size_t (*hash)(const void *),
+                             int (*compare)(const void *, const void *))
+{
+	return create_ilist_with_allocator(typesize, key, hash, compare, NULL);
+}
+
+struct ilist_t *create_ilist_with_allocator(size_t typesize,
+                                            const void *(*key)(const void *),
+                                            size_t (*hash)(const void *),
+                                            int (*compare)(const void *, const void *),
+                                            const struct list_allocator_t *allocator)
+{
+	struct ilist_t *list = (struct ilist_t *) malloc(sizeof(struct ilist_t));
+
+	if (!list) {
+		return NULL;
+	}
+
+	list->list = create_dlist_with_allocator(typesize, allocator);
+	list->index = create_list_index(key, hash, compare);
+	if (!list->list || !list->index) {
+		if (list->list) {
+			delete_dlist(list->list);
+		}
+		if (list->index) {
+			delete_list_index(list->index);
+		}
+		free(list);
+		return NULL;
+	}
+	return list;
+}
+
+struct delement_t *find_ielement(const void *key, struct ilist_t *list)
+{
+	if (!list) {
+		return NULL;
+	}
+	return (struct delement_t *) find_list_index(key, list->index);
+}
+
+size_t get_ilist_size(struct ilist_t *list)
+{
+	if (!list) {
+		return 0;
+	}
+	return list->list->size;
+}
+
+#ifdef LIST_DEBUG
+int ilist_verify(struct ilist_t *list)
+{
+	struct delement_t *element = NULL;
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+
+	error = dlist_verify(list->list);
+	if (error) {
+		return error;
+	}
+	if (list->index->count != list->list->size) {
+		return 7;
+	}
+	for (element = (struct delement_t *) list->list->base->next;
+	     element != list->list->base;
+	     element = (struct delement_t *) element->next) {
+		if (find_list_index(list->index->key(element->data), list->index) != element) {
+			return 8;
+		}
+	}
+	return 0;
+}
+#endif
+
+struct delement_t *add_ielement(size_t index, const void *data, struct ilist_t *list)
+{
+	if (!list || !data || index > list->list->size) {
+		return NULL;
+	}
+	return add_ielement_before(NULL, index, data, list);
+}
+
+struct delement_t *insert_ielement(struct delement_t *next, const void *data,
+                                   struct ilist_t *list)
+{
+	if (!list || !data || !next) {
+		return NULL;
+	}
+	return add_ielement_before(next, 0, data, list);
+}
+
+int remove_ielement(size_t index, struct ilist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (index >= list->list->size) {
+		return 3;
+	}
+	return erase_ielement(get_delement(index, list->list), list);
+}
+
+int erase_ielement(struct delement_t *element, struct ilist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (!element || element == list->list->base) {
+		return 4;
+	}
+
+	/* The key is read from the data before the element is freed */
+	if (erase_list_index((void *) element, list->index)) {
+		return 5;
+	}
+	return erase_delement(element, list->list);
+}
+
+int clear_ilist(struct ilist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (clear_list_index(list->index)) {
+		return 2;
+	}
+	return clear_dlist(list->list);
+}
+
+int delete_ilist(struct ilist_t *list)
+{
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+
+	error = delete_list_index(list->index);
+	if (delete_dlist(list->list)) {
+		error = 2;
+	}
+	free(list);
+	return error;
+}
+
+size_t mix_list_hash(size_t hash)
+{
+	/* Keys that hash to themselves, like numbers, are spread over all the
+	 * bits, the slots are chosen by the lowest ones */
+	hash ^= hash >> (sizeof(size_t) * 4);
+	hash *= (size_t) 0x9e3779b97f4a7c15ull;
+	hash ^= hash >> (sizeof(size_t) * 4);
+	return hash;
+}
+
+size_t find_list_index_slot(const void *key, size_t hash, struct list_index_t *index)
+{
+	struct list_index_slot_t *slot = NULL;
+	size_t mask = index->capacity - 1;
+	size_t i = hash & mask;
+	size_t distance = 0;
+
+	if (index->capacity == 0) {
+		return 0;
+	}
+
+	/* An element closer to its slot than the key would be means that the
+	 * key is not in the index, it would have taken the place */
+	for (;; i = (i + 1) & mask, distance++) {
+		slot = &index->slots[i];
+		if (!slot->element || ((i - slot->hash) & mask) < distance) {
+			return index->capacity;
+		}
+		if (slot->hash == hash
+		    && index->compare(index->key(*(void **) slot->element), key) == 0) {
+			return i;
+		}
+	}
+}
+
+void place_list_index_slot(size_t hash, void *element, struct list_index_t *index)
+{
+	struct list_index_slot_t *slot = NULL;
+	size_t mask = index->capacity - 1;
+	size_t i = hash & mask;
+	size_t distance = 0;
+	size_t slot_distance = 0;
+	size_t swap_hash = 0;
+	void *swap_element = NULL;
+
+	/* The one further from its slot stays, and the other one moves on */
+	for (;; i = (i + 1) & mask, distance++) {
+		slot = &index->slots[i];
+		if (!slot->element) {
+			slot->hash = hash;
+			slot->element = element;
+			return;
+		}
+		slot_distance = (i - slot->hash) & mask;
+		if (slot_distance < distance) {
+			swap_hash = slot->hash;
+			swap_element = slot->element;
+			slot->hash = hash;
+			slot->element = element;
+			hash = swap_hash;
+			element = swap_element;
+			distance = slot_distance;
+		}
+	}
+}
+
+struct delement_t *add_ielement_before(struct delement_t *next, size_t index,
+                                       const void *data, struct ilist_t *list)
+{
+	struct delement_t *element = NULL;
+
+	/* The index has room before the element is added, so that adding
+	 * to the index does not fail after */
+	if (find_list_index(list->index->key(data), list->index)
+	    || reserve_list_index(list->index->count + 1, list->index)) {
+		return NULL;
+	}
+
+	/* The element is added before the next, or at the index without it */
+	if (next) {
+		element = insert_delement(next, list->list);
+	} else {
+		element = add_delement(index, list->list);
+	}
+	if (!element) {
+		return NULL;
+	}
+
+	memcpy(element->data, data, list->list->typesize);
+	insert_list_index((void *) element, list->index);
+	return element;
+}
+
+/* LIST_IMPL */
+#endif
+
+/* ILIST_H */
+#endif
@@ -0,0 +1,445 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Indexed list for the C++ Wrapper of the Minimal C Linked List
+//   Usage and other information is provided in the README.md file from the
+//   repository. Please refer to that to know how to use this library.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILIST_HPP
+#define ILIST_HPP "ilist.hpp"
+
+// This header is just a wrapper for the index of the indexed list
+#include "ilist.h"
+#include "dlist.hpp"
+
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace aplib
+{
+// A doubly linked list of keys and values in the order they are added,
+// with an index finding the value of a key without walking the list. It
+// is an ordered map, or an LRU cache moving the used values to the front.
+// The hash and the equal are constructed when they are used
+template<typename key_t, typename type_t, typename hash_t = std::hash<key_t>,
+         typename equal_t = std::equal_to<key_t>,
+         typename alloc_t = std::allocator<std::pair<const key_t, type_t>>>
+class indexed_list
+{
+public:
+	using value_type = std::pair<const key_t, type_t>;
+	using list_type = dlist<value_type, alloc_t>;
+	using iterator = typename list_type::iterator;
+	using const_iterator = typename list_type::const_iterator;
+private:
+	list_type values;
+	list_index_t *index;
+
+	// The functions of the index are given the data of the elements
+	static const void *get_key(const void *data);
+	static size_t hash_key(const void *key);
+	static int compare_keys(const void *first, const void *second);
+
+	delement_t *element(const_iterator position) const;
+	void create_index();
+public:
+	indexed_list();
+	explicit indexed_list(const alloc_t &allocator);
+	indexed_list(const indexed_list &other);
+	indexed_list(indexed_list &&other) noexcept;
+	~indexed_list();
+
+	indexed_list &operator=(indexed_list other) noexcept;
+	void swap(indexed_list &other) noexcept;
+
+	size_t size() const;
+	iterator find(const key_t &key);
+	const_iterator find(const key_t &key) const;
+	bool contains(const key_t &key) const;
+	// Throws std::out_of_range if the key is not in the list
+	type_t &at(const key_t &key);
+	// Adds the key with a value constructed without arguments at the end
+	type_t &operator[](const key_t &key);
+
+	// The value is constructed from the arguments before the position,
+	// unless the key is in the list. The iterator of the key is returned
+	// with true if it is added
+	template<typename... args_t>
+	std::pair<iterator, bool> emplace(const_iterator position, const key_t &key,
+	                                  args_t &&... args);
+	template<typename... args_t>
+	std::pair<iterator, bool> emplace_front(const key_t &key, args_t &&... args);
+	template<typename... args_t>
+	std::pair<iterator, bool> emplace_back(const key_t &key, args_t &&... args);
+
+	iterator erase(const_iterator position);
+	// Returns the number of values removed, 0 or 1
+	size_t erase(const key_t &key);
+	indexed_list &pop_front();
+	indexed_list &pop_back();
+	indexed_list &clear();
+
+	// Moves the value before the next position without copying it
+	indexed_list &move(const_iterator position, const_iterator next);
+	indexed_list &move_to_front(const_iterator position);
+	indexed_list &move_to_back(const_iterator position);
+
+	value_type &front();
+	value_type &back();
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+};
+}
+
+#ifdef LIST_IMPL
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+const void *aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::get_key(const void *data)
+{
+	return (const void *) &((const value_type *) data)->first;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+size_t aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::hash_key(const void *key)
+{
+	return hash_t()(*(const key_t *) key);
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+int aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::compare_keys(const void *first,
+        const void *second)
+{
+	return equal_t()(*(const key_t *) first, *(const key_t *) second) ? 0 : 1;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+delement_t *aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::element(const_iterator position) const
+{
+	// The end is the base of the list
+	if (position == values.end()) {
+		return values.native_handle()->base;
+	}
+	return get_data_delement((void *) &*position, values.native_handle());
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+void aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::create_index()
+{
+	index = create_list_index(get_key, hash_key, compare_keys);
+	if (!index) {
+		throw std::bad_alloc();
+	}
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::indexed_list()
+	: indexed_list(alloc_t())
+{
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::indexed_list(const alloc_t &allocator)
+	: values(allocator)
+{
+	create_index();
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::indexed_list(const indexed_list &other)
+	: values(other.values)
+{
+	create_index();
+
+	// The destructor is not called if the constructor throws
+	if (reserve_list_index(values.size(), index)) {
+		delete_list_index(index);
+		throw std::bad_alloc();
+	}
+	for (iterator position = values.begin(); position != values.end(); ++position) {
+		insert_list_index((void *) element(position), index);
+	}
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::indexed_list(indexed_list &&other) noexcept
+	: values(std::move(other.values)), index(other.index)
+{
+	// The elements are not moved, so the index still finds them
+	other.index = nullptr;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::~indexed_list()
+{
+	// A moved from list has no index
+	if (index) {
+		delete_list_index(index);
+	}
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t> &
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::operator=(indexed_list other) noexcept
+{
+	swap(other);
+	return *this;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+void aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::swap(indexed_list &other) noexcept
+{
+	using std::swap;
+	values.swap(other.values);
+	swap(index, other.index);
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+size_t aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::size() const
+{
+	return values.size();
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::iterator
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::find(const key_t &key)
+{
+	delement_t *found = (delement_t *) find_list_index((const void *) &key, index);
+
+	return found ? iterator(found) : values.end();
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::const_iterator
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::find(const key_t &key) const
+{
+	delement_t *found = (delement_t *) find_list_index((const void *) &key, index);
+
+	return found ? const_iterator(found) : values.end();
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+bool aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::contains(const key_t &key) const
+{
+	return find_list_index((const void *) &key, index) != nullptr;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+type_t &aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::at(const key_t &key)
+{
+	iterator found = find(key);
+
+	if (found == values.end()) {
+		throw std::out_of_range("aplib::indexed_list::at");
+	}
+	return found->second;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+type_t &aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::operator[](const key_t &key)
+{
+	return emplace_back(key).first->second;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+template<typename... args_t>
+std::pair<typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::iterator, bool>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::emplace(const_iterator position,
+        const key_t &key, args_t &&... args)
+{
+	iterator found = find(key);
+	iterator added;
+
+	if (found != values.end()) {
+		return std::make_pair(found, false);
+	}
+
+	// The index has room before the value is added, so that adding
+	// to the index does not fail after
+	if (reserve_list_index(values.size() + 1, index)) {
+		throw std::bad_alloc();
+	}
+	added = values.emplace(position, std::piecewise_construct,
+	                       std::forward_as_tuple(key),
+	                       std::forward_as_tuple(std::forward<args_t>(args)...));
+	insert_list_index((void *) element(added), index);
+	return std::make_pair(added, true);
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+template<typename... args_t>
+std::pair<typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::iterator, bool>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::emplace_front(const key_t &key,
+        args_t &&... args)
+{
+	return emplace(values.begin(), key, std::forward<args_t>(args)...);
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+template<typename... args_t>
+std::pair<typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::iterator, bool>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::emplace_back(const key_t &key,
+        args_t &&... args)
+{
+	return emplace(values.end(), key, std::forward<args_t>(args)...);
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::iterator
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::erase(const_iterator position)
+{
+	// The key is read from the value before it is destroyed
+	erase_list_index((void *) element(position), index);
+	return values.erase(position);
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+size_t aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::erase(const key_t &key)
+{
+	iterator found = find(key);
+
+	if (found == values.end()) {
+		return 0;
+	}
+	erase(found);
+	return 1;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t> &
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::pop_front()
+{
+	if (values.size() > 0) {
+		erase(values.begin());
+	}
+	return *this;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t> &
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::pop_back()
+{
+	if (values.size() > 0) {
+		erase(--values.end());
+	}
+	return *this;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t> &
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::clear()
+{
+	clear_list_index(index);
+	values.clear();
+	return *this;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t> &
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::move(const_iterator position,
+        const_iterator next)
+{
+	move_delement(element(position), element(next), values.native_handle());
+	return *this;
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t> &
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::move_to_front(const_iterator position)
+{
+	return move(position, values.begin());
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t> &
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::move_to_back(const_iterator position)
+{
+	return move(position, values.end());
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::value_type &
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::front()
+{
+	return values.front();
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::value_type &
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::back()
+{
+	return values.back();
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::iterator
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::begin()
+{
+	return values.begin();
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::iterator
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::end()
+{
+	return values.end();
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::const_iterator
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::begin() const
+{
+	return values.begin();
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::const_iterator
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::end() const
+{
+	return values.end();
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::const_iterator
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::cbegin() const
+{
+	return values.cbegin();
+}
+
+template<typename key_t, typename type_t, typename hash_t, typename equal_t, typename alloc_t>
+typename aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::const_iterator
+aplib::indexed_list<key_t, type_t, hash_t, equal_t, alloc_t>::cend() const
+{
+	return values.cend();
+}
+
+// LIST_IMPL
+#endif
+
+// ILIST_HPP
+#endif
@@ -0,0 +1,507 @@
+/*
+ * Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * A Minimal C Lock-Free Linked List
+ *   Usage and other information is provided in the README.md file from the
+ *   repository. Please refer to that to know how to use this library.
+ */
+
+#ifndef LFLIST_H
+#define LFLIST_H "lflist.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* The lock-free list uses the allocators of the list */
+#include "list.h"
+
+/* Implement the list code by defining
+ * LIST_IMPL before including this library */
+
+/* The list is made for GCC and Clang, it uses their __atomic built-ins
+ * so that the same code builds as C and as C++. Elements are removed by
+ * marking their next first and unlinking them after (Harris). Removed
+ * elements are freed once no thread can be using them (epoch based) */
+
+/* The maximum number of threads using a list at the same time */
+#ifndef LFLIST_THREADS
+#define LFLIST_THREADS 64
+#endif
+
+/* The removed elements of a thread are checked for freeing every this many */
+#ifndef LFLIST_RETIRE_INTERVAL
+#define LFLIST_RETIRE_INTERVAL 32
+#endif
+
+/* The data of an element is allocated together with the element, and
+ * it is copied in before the element is added to the list */
+struct lfelement_t {
+	void *data;
+	/* The lowest bit of the next marks the element as removed */
+	void *next;
+	/* Links the removed elements waiting to be freed */
+	void *retired;
+};
+
+/* A thread joins a list to use it. The elements it removed wait in one of
+ * three lists until two epochs have passed, then nobody can be using them */
+struct lfthread_t {
+	struct lflist_t *list;
+	int in_use;
+	int active;
+	size_t epoch;
+	size_t retire_count;
+	struct lfelement_t *retired[3];
+	size_t retired_epoch[3];
+	/* Keeps the threads that are written to often off the same cache line */
+	char padding[64];
+};
+
+struct lflist_t {
+	/* The base does not contain an element,
+	 * the next of the base is the first element */
+	struct lfelement_t *base;
+	/* The size changes while the list is used, it is only a hint */
+	size_t size;
+	size_t typesize;
+	/* The global epoch, it advances when every active thread has seen it */
+	size_t epoch;
+	struct lfthread_t threads[LFLIST_THREADS];
+	/* The allocator is used from many threads, it has to be thread safe */
+	struct list_allocator_t allocator;
+};
+
+
+struct lflist_t *create_lflist(size_t typesize);
+/* The allocator is copied into the list, the elements are
+ * allocated using malloc if the allocator is NULL */
+struct lflist_t *create_lflist_with_allocator(size_t typesize,
+                                              const struct list_allocator_t *allocator);
+size_t get_lflist_size(struct lflist_t *list);
+
+/* Every thread joins a list before using it, NULL is returned if
+ * LFLIST_THREADS threads have joined already. A thread leaves the
+ * list when it is done, the list can not be used after leaving */
+struct lfthread_t *join_lflist(struct lflist_t *list);
+int leave_lflist(struct lfthread_t *thread);
+
+/* Elements are only used between entering and exiting, the elements
+ * got in between are not freed until the thread exits. All of the
+ * functions below must be called between entering and exiting */
+void enter_lflist(struct lfthread_t *thread);
+void exit_lflist(struct lfthread_t *thread);
+
+/* The first element and the next element, skipping the removed
+ * elements. NULL is returned at the end of the list */
+struct lfelement_t *first_lfelement(struct lfthread_t *thread);
+struct lfelement_t *next_lfelement(struct lfelement_t *element,
+                                   struct lfthread_t *thread);
+
+/* Adds an element after the given element, or at the beginning if it is
+ * the base. The data is copied into the element before it is added. NULL
+ * is returned if the given element was removed by another thread */
+struct lfelement_t *insert_lfelement(struct lfelement_t *prev, const void *data,
+                                     struct lfthread_t *thread);
+/* Returns 2 if another thread removed the element first */
+int remove_lfelement(struct lfelement_t *element, struct lfthread_t *thread);
+
+/* Deleting a list is not thread safe, every thread must have left it */
+int delete_lflist(struct lflist_t *list);
+
+/* These functions are not supposed to be used externally */
+struct lfelement_t *create_lfelement(struct lflist_t *list);
+int delete_lfelement(struct lfelement_t *element, struct lflist_t *list);
+void unlink_lfelement(struct lfelement_t *element, struct lfthread_t *thread);
+void retire_lfelement(struct lfelement_t *element, struct lfthread_t *thread);
+void free_lfelements(struct lfelement_t *element, struct lflist_t *list);
+void advance_lflist_epoch(struct lflist_t *list);
+
+#define LFLIST_MARKED(pointer) ((uintptr_t) (pointer) & 1)
+#define LFLIST_UNMARKED(pointer) \
+	((struct lfelement_t *) ((uintptr_t) (pointer) & ~(uintptr_t) 1))
+
+#ifdef LIST_IMPL
+
+struct lflist_t *create_lflist(size_t typesize)
+{
+	return create_lflist_with_allocator(typesize, NULL);
+}
+
+struct lflist_t *create_lflist_with_allocator(size_t typesize,
+                                              const struct list_allocator_t *allocator)
+{
+	struct lflist_t *list = (struct lflist_t *) malloc(sizeof(struct lflist_t));
+
+	if (!list) {
+		return NULL;
+	}
+
+	list->size = 0;
+	list->typesize = typesize;
+	list->epoch = 0;
+	for (size_t i = 0; i < LFLIST_THREADS; i++) {
+		list->threads[i].list = list;
+		list->threads[i].in_use = 0;
+		list->threads[i].active = 0;
+		list->threads[i].epoch = 0;
+		list->threads[i].retire_count = 0;
+		for (size_t j = 0; j < 3; j++) {
+			list->threads[i].retired[j] = NULL;
+			list->threads[i].retired_epoch[j] = 0;
+		}
+	}
+	list->allocator.allocate = NULL;
+	list->allocator.deallocate = NULL;
+	list->allocator.release = NULL;
+	list->allocator.context = NULL;
+	if (allocator) {
+		list->allocator = *allocator;
+	}
+	list->base = (struct lfelement_t *) malloc(sizeof(struct lfelement_t));
+
+	if (!list->base) {
+		free(list);
+		return NULL;
+	}
+
+	list->base->data = NULL;
+	list->base->next = NULL;
+	list->base->retired = NULL;
+	return list;
+}
+
+size_t get_lflist_size(struct lflist_t *list)
+{
+	if (!list) {
+		return 0;
+	}
+	return __atomic_load_n(&list->size, __ATOMIC_RELAXED);
+}
+
+
+
+struct lfthread_t *join_lflist(struct lflist_t *list)
+{
+	int in_use = 0;
+
+	if (!list) {
+		return NULL;
+	}
+
+	for (size_t i = 0; i < LFLIST_THREADS; i++) {
+		in_use = 0;
+		if (__atomic_compare_exchange_n(&list->threads[i].in_use, &in_use, 1,
+		                                0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			return &list->threads[i];
+		}
+	}
+	return NULL;
+}
+
+int leave_lflist(struct lfthread_t *thread)
+{
+	if (!thread) {
+		return 1;
+	}
+
+	/* The removed elements stay with the thread, the next thread
+	 * joining frees them once it is safe, or the list does */
+	__atomic_store_n(&thread->active, 0, __ATOMIC_RELEASE);
+	__atomic_store_n(&thread->in_use, 0, __ATOMIC_RELEASE);
+	return 0;
+}
+
+void enter_lflist(struct lfthread_t *thread)
+{
+	size_t epoch = 0;
+
+	__atomic_store_n(&thread->active, 1, __ATOMIC_SEQ_CST);
+	epoch = __atomic_load_n(&thread->list->epoch, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&thread->epoch, epoch, __ATOMIC_SEQ_CST);
+
+	/* The elements removed two or more epochs ago can not be in use */
+	for (size_t i = 0; i < 3; i++) {
+		if (thread->retired[i] && thread->retired_epoch[i] + 2 <= epoch) {
+			free_lfelements(thread->retired[i], thread->list);
+			thread->retired[i] = NULL;
+		}
+	}
+}
+
+void exit_lflist(struct lfthread_t *thread)
+{
+	__atomic_store_n(&thread->active, 0, __ATOMIC_RELEASE);
+}
+
+
+
+struct lfelement_t *first_lfelement(struct lfthread_t *thread)
+{
+	return next_lfelement(thread->list->base, thread);
+}
+
+struct lfelement_t *next_lfelement(struct lfelement_t *element,
+                                   struct lfthread_t *thread)
+{
+	void *next = NULL;
+
+	(void) thread;
+	if (!element) {
+		return NULL;
+	}
+
+	element = LFLIST_UNMARKED(__atomic_load_n(&element->next, __ATOMIC_ACQUIRE));
+	while (element) {
+		next = __atomic_load_n(&element->next, __ATOMIC_ACQUIRE);
+		if (!LFLIST_MARKED(next)) {
+			return element;
+		}
+		element = LFLIST_UNMARKED(next);
+	}
+	return NULL;
+}
+
+struct lfelement_t *insert_lfelement(struct lfelement_t *prev, const void *data,
+                                     struct lfthread_t *thread)
+{
+	struct lfelement_t *new_element = NULL;
+	void *next = NULL;
+
+	if (!prev || !thread) {
+		return NULL;
+	}
+
+	new_element = create_lfelement(thread->list);
+	if (!new_element) {
+		return NULL;
+	}
+	if (data) {
+		memcpy(new_element->data, data, thread->list->typesize);
+	}
+
+	next = __atomic_load_n(&prev->next, __ATOMIC_ACQUIRE);
+	do {
+		/* Nothing can be added after a removed element, the new
+		 * element was never seen by other threads so it is freed */
+		if (LFLIST_MARKED(next)) {
+			delete_lfelement(new_element, thread->list);
+			return NULL;
+		}
+		new_element->next = next;
+	} while (!__atomic_compare_exchange_n(&prev->next, &next, (void *) new_element,
+	                                      0, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+
+	__atomic_fetch_add(&thread->list->size, 1, __ATOMIC_RELAXED);
+	return new_element;
+}
+
+int remove_lfelement(struct lfelement_t *element, struct lfthread_t *thread)
+{
+	void *next = NULL;
+
+	if (!thread) {
+		return 1;
+	}
+	if (!element || element == thread->list->base) {
+		return 4;
+	}
+
+	/* Marking the element removes it, only one thread can mark it */
+	next = __atomic_load_n(&element->next, __ATOMIC_ACQUIRE);
+	do {
+		if (LFLIST_MARKED(next)) {
+			return 2;
+		}
+	} while (!__atomic_compare_exchange_n(&element->next, &next,
+	                                      (void *) ((uintptr_t) next | 1), 0,
+	                                      __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+	__atomic_fetch_sub(&thread->list->size, 1, __ATOMIC_RELAXED);
+	unlink_lfelement(element, thread);
+	return 0;
+}
+
+int delete_lflist(struct lflist_t *list)
+{
+	struct lfelement_t *element = NULL;
+	struct lfelement_t *next = NULL;
+
+	if (!list) {
+		return 1;
+	}
+	if (!list->base) {
+		return 3;
+	}
+
+	/* Marked elements that were not unlinked yet are still linked */
+	element = LFLIST_UNMARKED(list->base->next);
+	while (element) {
+		next = LFLIST_UNMARKED(element->next);
+		delete_lfelement(element, list);
+		element = next;
+	}
+	for (size_t i = 0; i < LFLIST_THREADS; i++) {
+		for (size_t j = 0; j < 3; j++) {
+			free_lfelements(list->threads[i].retired[j], list);
+		}
+	}
+
+	free(list->base);
+	free(list);
+	return 0;
+}
+
+
+
+struct lfelement_t *create_lfelement(struct lflist_t *list)
+{
+	struct lfelement_t *element = NULL;
+	size_t offset = 0;
+
+	if (!list) {
+		return NULL;
+	}
+
+	offset = align_data_offset(sizeof(struct lfelement_t), list->typesize);
+	if (list->allocator.allocate) {
+		element = (struct lfelement_t *) list->allocator.allocate(
+		                  list->allocator.context, offset + list->typesize);
+	} else {
+		element = (struct lfelement_t *) malloc(offset + list->typesize);
+	}
+	if (!element) {
+		return NULL;
+	}
+
+	element->next = NULL;
+	element->retired = NULL;
+	element->data = (void *) ((char *) element + offset);
+	return element;
+}
+
+int delete_lfelement(struct lfelement_t *element, struct lflist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (!element) {
+		return 1;
+	}
+
+	/* The data is freed along with the element */
+	if (list->allocator.deallocate) {
+		list->allocator.deallocate(list->allocator.context, element,
+		                           align_data_offset(sizeof(struct lfelement_t),
+		                                             list->typesize) + list->typesize);
+	} else {
+		free(element);
+	}
+	return 0;
+}
+
+void unlink_lfelement(struct lfelement_t *element, struct lfthread_t *thread)
+{
+	struct lfelement_t *prev = NULL;
+	struct lfelement_t *current = NULL;
+	void *expected = NULL;
+	void *next = NULL;
+
+retry:
+	prev = thread->list->base;
+	current = LFLIST_UNMARKED(__atomic_load_n(&prev->next, __ATOMIC_ACQUIRE));
+
+	/* Every removed element found on the way is unlinked as well. The
+	 * element is done once it is not found, another thread unlinked it */
+	while (current) {
+		next = __atomic_load_n(&current->next, __ATOMIC_ACQUIRE);
+		if (!LFLIST_MARKED(next)) {
+			prev = current;
+			current = (struct lfelement_t *) next;
+			continue;
+		}
+
+		/* The previous element changed or was removed, start again */
+		expected = (void *) current;
+		if (!__atomic_compare_exchange_n(&prev->next, &expected,
+		                                 (void *) LFLIST_UNMARKED(next), 0,
+		                                 __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			goto retry;
+		}
+		retire_lfelement(current, thread);
+		if (current == element) {
+			return;
+		}
+		current = LFLIST_UNMARKED(next);
+	}
+}
+
+void retire_lfelement(struct lfelement_t *element, struct lfthread_t *thread)
+{
+	/* The epoch is read after the element was unlinked, the threads
+	 * that can still be using it are in this epoch or an earlier one */
+	size_t epoch = __atomic_load_n(&thread->list->epoch, __ATOMIC_SEQ_CST);
+	size_t i = epoch % 3;
+
+	/* The elements left from three epochs ago are safe to free */
+	if (thread->retired_epoch[i] != epoch) {
+		free_lfelements(thread->retired[i], thread->list);
+		thread->retired[i] = NULL;
+		thread->retired_epoch[i] = epoch;
+	}
+	element->retired = (void *) thread->retired[i];
+	thread->retired[i] = element;
+
+	if (++thread->retire_count % LFLIST_RETIRE_INTERVAL == 0) {
+		advance_lflist_epoch(thread->list);
+	}
+}
+
+void free_lfelements(struct lfelement_t *element, struct lflist_t *list)
+{
+	struct lfelement_t *retired = NULL;
+
+	while (element) {
+		retired = (struct lfelement_t *) element->retired;
+		delete_lfelement(element, list);
+		element = retired;
+	}
+}
+
+void advance_lflist_epoch(struct lflist_t *list)
+{
+	size_t epoch = __atomic_load_n(&list->epoch, __ATOMIC_SEQ_CST);
+
+	/* Every active thread has to be in the current epoch */
+	for (size_t i = 0; i < LFLIST_THREADS; i++) {
+		if (__atomic_load_n(&list->threads[i].active, __ATOMIC_SEQ_CST)
+		    && __atomic_load_n(&list->threads[i].epoch, __ATOMIC_SEQ_CST) != epoch) {
+			return;
+		}
+	}
+	__atomic_compare_exchange_n(&list->epoch, &epoch, epoch + 1, 0,
+	                            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+/* LIST_IMPL */
+#endif
+
+/* LFLIST_H */
+#endif
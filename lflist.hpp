@@ -0,0 +1,266 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// The lock-free list for the C++ Wrapper of the Minimal C Linked List
+//   Usage and other information is provided in the README.md file from the
+//   repository. Please refer to that to know how to use this library.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LFLIST_HPP
+#define LFLIST_HPP "lflist.hpp"
+
+// This header is just a wrapper for the Minimal C Lock-Free Linked List
+#include "lflist.h"
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+namespace aplib
+{
+// Every thread using the list joins it and uses the list through its
+// session. Values are copied in and out of the list, elements are never
+// given out since another thread may remove them at any time
+template<typename type_t>
+class concurrent_list
+{
+	// Values are copied into the elements before they are added
+	static_assert(std::is_trivially_copyable<type_t>::value,
+	              "The values are copied, the type must be trivially copyable");
+	lflist_t *internal_list;
+public:
+	class session;
+
+	concurrent_list();
+	~concurrent_list();
+	concurrent_list(const concurrent_list &other) = delete;
+	concurrent_list &operator=(const concurrent_list &other) = delete;
+
+	// The size changes while other threads use the list
+	size_t size() const;
+	// Throws std::length_error if LFLIST_THREADS sessions are open
+	session join();
+
+	class session
+	{
+		lfthread_t *thread;
+		explicit session(lfthread_t *thread);
+
+		// Exits the list even if a given function throws
+		struct guard
+		{
+			lfthread_t *thread;
+			explicit guard(lfthread_t *thread);
+			~guard();
+		};
+	public:
+		session(session &&other) noexcept;
+		session &operator=(session &&other) noexcept;
+		session(const session &other) = delete;
+		session &operator=(const session &other) = delete;
+		~session();
+
+		void push_front(const type_t &value);
+		// Adds the value after the first value matching the predicate
+		template<typename predicate_t>
+		bool insert_after(predicate_t predicate, const type_t &value);
+		// Returns the number of values this session removed
+		template<typename predicate_t>
+		size_t remove_if(predicate_t predicate);
+		// Copies the first value matching the predicate
+		template<typename predicate_t>
+		bool find_if(predicate_t predicate, type_t &value);
+		template<typename function_t>
+		void for_each(function_t function);
+
+		friend class concurrent_list;
+	};
+};
+}
+
+#ifdef LIST_IMPL
+
+template<typename type_t>
+aplib::concurrent_list<type_t>::concurrent_list()
+{
+	internal_list = create_lflist(sizeof(type_t));
+	if (!internal_list) {
+		throw std::bad_alloc();
+	}
+}
+
+template<typename type_t>
+aplib::concurrent_list<type_t>::~concurrent_list()
+{
+	delete_lflist(internal_list);
+}
+
+template<typename type_t>
+size_t aplib::concurrent_list<type_t>::size() const
+{
+	return get_lflist_size(internal_list);
+}
+
+template<typename type_t>
+typename aplib::concurrent_list<type_t>::session aplib::concurrent_list<type_t>::join()
+{
+	lfthread_t *thread = join_lflist(internal_list);
+
+	if (!thread) {
+		throw std::length_error("Too many threads joined the list");
+	}
+	return session(thread);
+}
+
+template<typename type_t>
+aplib::concurrent_list<type_t>::session::session(lfthread_t *thread)
+	: thread(thread)
+{
+}
+
+template<typename type_t>
+aplib::concurrent_list<type_t>::session::session(session &&other) noexcept
+	: thread(other.thread)
+{
+	other.thread = nullptr;
+}
+
+template<typename type_t>
+typename aplib::concurrent_list<type_t>::session &
+aplib::concurrent_list<type_t>::session::operator=(session &&other) noexcept
+{
+	if (this != &other) {
+		leave_lflist(thread);
+		thread = other.thread;
+		other.thread = nullptr;
+	}
+	return *this;
+}
+
+template<typename type_t>
+aplib::concurrent_list<type_t>::session::~session()
+{
+	leave_lflist(thread);
+}
+
+template<typename type_t>
+aplib::concurrent_list<type_t>::session::guard::guard(lfthread_t *thread)
+	: thread(thread)
+{
+	enter_lflist(thread);
+}
+
+template<typename type_t>
+aplib::concurrent_list<type_t>::session::guard::~guard()
+{
+	exit_lflist(thread);
+}
+
+template<typename type_t>
+void aplib::concurrent_list<type_t>::session::push_front(const type_t &value)
+{
+	guard entered(thread);
+
+	// The base is never removed, adding after it can not fail otherwise
+	if (!insert_lfelement(thread->list->base, &value, thread)) {
+		throw std::bad_alloc();
+	}
+}
+
+template<typename type_t>
+template<typename predicate_t>
+bool aplib::concurrent_list<type_t>::session::insert_after(predicate_t predicate,
+        const type_t &value)
+{
+	guard entered(thread);
+	lfelement_t *element = first_lfelement(thread);
+
+	// The matching element may be removed before adding, look again then
+	while (element) {
+		if (!predicate(*(const type_t *) element->data)) {
+			element = next_lfelement(element, thread);
+			continue;
+		}
+		if (insert_lfelement(element, &value, thread)) {
+			return true;
+		}
+		if (!LFLIST_MARKED(__atomic_load_n(&element->next, __ATOMIC_ACQUIRE))) {
+			throw std::bad_alloc();
+		}
+		element = next_lfelement(element, thread);
+	}
+	return false;
+}
+
+template<typename type_t>
+template<typename predicate_t>
+size_t aplib::concurrent_list<type_t>::session::remove_if(predicate_t predicate)
+{
+	guard entered(thread);
+	lfelement_t *element = first_lfelement(thread);
+	size_t removed = 0;
+
+	// Removed elements are not freed before exiting, walking on is safe
+	while (element) {
+		if (predicate(*(const type_t *) element->data)
+		    && remove_lfelement(element, thread) == 0) {
+			removed++;
+		}
+		element = next_lfelement(element, thread);
+	}
+	return removed;
+}
+
+template<typename type_t>
+template<typename predicate_t>
+bool aplib::concurrent_list<type_t>::session::find_if(predicate_t predicate,
+        type_t &value)
+{
+	guard entered(thread);
+
+	for (lfelement_t *element = first_lfelement(thread); element;
+	     element = next_lfelement(element, thread)) {
+		if (predicate(*(const type_t *) element->data)) {
+			value = *(const type_t *) element->data;
+			return true;
+		}
+	}
+	return false;
+}
+
+template<typename type_t>
+template<typename function_t>
+void aplib::concurrent_list<type_t>::session::for_each(function_t function)
+{
+	guard entered(thread);
+
+	for (lfelement_t *element = first_lfelement(thread); element;
+	     element = next_lfelement(element, thread)) {
+		function(*(const type_t *) element->data);
+	}
+}
+
+// LIST_IMPL
+#endif
+
+// LFLIST_HPP
+#endif
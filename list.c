@@ -25,6 +25,23 @@
 /* Including the list with implementations. */
 #define LIST_IMPL
 #include "list.h"
+#include "dlist.h"
+#include "ulist.h"
+#include "skiplist.h"
+#include "tlist.h"
+#include "listio.h"
+
+/* The lock-free lists use the atomics of GCC and Clang, and the mapped
+ * list is made for POSIX systems */
+#if defined(__GNUC__)
+#include "lflist.h"
+#include "lqueue.h"
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include "mlist.h"
+#endif
+#include "scan.h"
+#include "ilist.h"
 
 /*
  * The purpose of this file is in creation of static/dynamic library.
@@ -26,6 +26,20 @@
 // Including the list with implementations.
 #define LIST_IMPL
 #include "list.hpp"
+#include "dlist.hpp"
+#include "ulist.hpp"
+#include "tlist.hpp"
+#include "listio.hpp"
+#include "parallel.hpp"
+#include "scan.hpp"
+#include "ilist.hpp"
+#include "smlist.hpp"
+
+// The lock-free lists use the atomics of GCC and Clang
+#if defined(__GNUC__)
+#include "lflist.hpp"
+#include "lqueue.hpp"
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 // The purpose of this file is in creation of static/dynamic library.
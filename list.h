@@ -27,47 +27,286 @@
 #ifndef LIST_H
 #define LIST_H "list.h"
 
+#include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef LIST_STATS
+#include <pthread.h>
+#include <stdio.h>
+#endif
+
+/* Define LIST_USDT to place USDT probes (for perf, bpftrace and the like)
+ * in add_element, remove_element and get_element, it needs <sys/sdt.h> */
+#ifdef LIST_USDT
+#include <sys/sdt.h>
+#endif
 
 /* Implement the list code by defining
  * LIST_IMPL before including this library */
 
+/* The data of an element is allocated together with the element, it is
+ * placed right after it and aligned for the size of the type, up to the
+ * maximum alignment. The data pointer points to it for convenience */
 struct element_t{
 	void *data;
 	void *next;
 };
 
+/* The maximum alignment of the fundamental types */
+struct list_align_t {
+	char c;
+	union {
+		long long ll;
+		long double ld;
+		void *p;
+		void (*f)(void);
+	} u;
+};
+#define LIST_MAX_ALIGN offsetof(struct list_align_t, u)
+
+/* Custom allocation for the elements of a list. The context is given back
+ * to the functions as the first argument. Release is optional, it frees
+ * all the elements of a list at once and is used for clearing the list */
+struct list_allocator_t {
+	void *(*allocate)(void *context, size_t size);
+	void (*deallocate)(void *context, void *pointer, size_t size);
+	void (*release)(void *context);
+	void *context;
+};
+
+/* A pool hands out the elements of a list from chunks that hold chunk_size
+ * elements each, removed elements are reused and the chunks are freed all
+ * at once when the list is cleared. A pool must be used by one list only */
+struct list_pool_t {
+	/* Chunks and removed elements are linked through their first bytes */
+	void *chunks;
+	void *free;
+	/* The elements not handed out yet from the last chunk */
+	char *next;
+	size_t remaining;
+	size_t element_size;
+	size_t chunk_size;
+};
+
+/* Define LIST_STATS to count what every list does, nothing is allocated
+ * or counted when it is not defined. Build the implementation with it */
+struct list_stats_t {
+	/* Calls adding, removing and getting elements, including the calls
+	 * the functions of the list make themselves */
+	size_t adds;
+	size_t removes;
+	size_t gets;
+	/* The elements walked by get_element, divide it by the gets for
+	 * the average, a high average is a list used like an array */
+	size_t walked;
+	size_t allocations;
+	size_t frees;
+	size_t allocated_bytes;
+	size_t freed_bytes;
+	size_t max_size;
+};
+
 struct list_t {
 	/* The base does not contain an element,
 	 * the next of the base is the index of 0 */
 	struct element_t *base;
+	/* The last element, used to add elements at the end without walking */
+	struct element_t *tail;
+	/* The last accessed element and its index, walking continues from
+	 * here when possible so that sequential access does not restart */
+	struct element_t *cursor;
+	size_t cursor_index;
 	/* Update the size of the list when modifying externally */
 	size_t size;
 	size_t typesize;
+	/* Elements are allocated using malloc if there is no allocate */
+	struct list_allocator_t allocator;
+	/* The base lives in the list, so a list in your own struct or on
+	 * the stack is initialized without allocating. The list must not
+	 * be copied or moved after that, the base points into it */
+	struct element_t base_element;
+	/* The entry of the list in the registry, NULL without LIST_STATS.
+	 * The stats are not in the list, so that the list is the same with
+	 * and without it and code built either way can share lists */
+	struct list_entry_t *entry;
 };
 
+/* Every list is in the registry from its init to its destroy */
+struct list_entry_t {
+	struct list_stats_t stats;
+	struct list_t *list;
+	struct list_entry_t *prev;
+	struct list_entry_t *next;
+};
+
+#ifdef LIST_STATS
+#define LIST_COUNT(list, counter, count) \
+	((list)->entry ? (void) ((list)->entry->stats.counter += (count)) : (void) 0)
+#define LIST_COUNT_SIZE(list) \
+	((list)->entry && (list)->size > (list)->entry->stats.max_size \
+	 ? (void) ((list)->entry->stats.max_size = (list)->size) : (void) 0)
+#else
+#define LIST_COUNT(list, counter, count) ((void) 0)
+#define LIST_COUNT_SIZE(list) ((void) 0)
+#endif
+
+#ifdef LIST_USDT
+#define LIST_TRACE(probe, list, index) DTRACE_PROBE2(aplist, probe, list, index)
+#define LIST_TRACE_WALK(probe, list, index, walked) \
+	DTRACE_PROBE3(aplist, probe, list, index, walked)
+#else
+#define LIST_TRACE(probe, list, index) ((void) 0)
+#define LIST_TRACE_WALK(probe, list, index, walked) ((void) 0)
+#endif
+
+/* Gives the struct containing a member from a pointer to the member, like
+ * the struct containing the element of an intrusive list */
+#ifndef container_of
+#define container_of(pointer, type, member) \
+	((type *) ((char *) (pointer) - offsetof(type, member)))
+#endif
 
 struct list_t *create_list(size_t typesize);
+/* The allocator is copied into the list, the elements are
+ * allocated using malloc if the allocator is NULL */
+struct list_t *create_list_with_allocator(size_t typesize,
+                                          const struct list_allocator_t *allocator);
+/* Initializes a list in memory you own, nothing is allocated. Destroy it
+ * using list_destroy, which clears the list and does not free it */
+int list_init(size_t typesize, const struct list_allocator_t *allocator,
+              struct list_t *list);
+int list_destroy(struct list_t *list);
 struct element_t *get_element(size_t index, struct list_t *list);
 
+/* Walks the list to update the size, tail and last accessed
+ * element, use it only after modifying the list externally */
 int update_list_size(struct list_t *list);
 size_t get_list_size(struct list_t *list);
 
+/* Define LIST_DEBUG to check the size, tail,
+ * last accessed element and links of a list */
+#ifdef LIST_DEBUG
+int list_verify(struct list_t *list);
+#endif
+
+#ifdef LIST_STATS
+/* The lists created or initialized and not deleted or destroyed yet, a
+ * list is not in it if its entry could not be allocated */
+extern struct list_entry_t *list_registry;
+extern pthread_mutex_t list_registry_mutex;
+
+int list_get_stats(struct list_stats_t *stats, struct list_t *list);
+int list_reset_stats(struct list_t *list);
+/* Writes the stats of every list in the registry as a JSON array. The
+ * lists must not be changed while they are written, the registry can */
+int list_dump_stats(FILE *file);
+#endif
+
 /* These functions are not supposed to be used externally */
+size_t align_data_offset(size_t offset, size_t typesize);
+size_t get_data_offset(size_t typesize);
 struct element_t *create_element(size_t typesize);
 int delete_element(struct element_t *element);
+struct element_t *create_list_element(struct list_t *list);
+int delete_list_element(struct element_t *element, struct list_t *list);
 
 /* You can add element at the end of the
  * list by giving it the size of the list */
 struct element_t *add_element(size_t index, struct list_t *list);
 int remove_element(size_t index, struct list_t *list);
 
+/* Adds or removes count elements at the index walking the list once. The
+ * data of count elements is copied into the added elements if it is not
+ * NULL, nothing is added if any of them fails to be allocated */
+struct element_t *add_elements(size_t index, const void *data, size_t count,
+                               struct list_t *list);
+int remove_elements(size_t index, size_t count, struct list_t *list);
+
+/* Moves all the elements of the other list to the index of the list and
+ * leaves the other list empty, give it the size of the list to append.
+ * Both lists must have the same type and allocator, one not using a pool.
+ * Moving to the beginning or the end does not walk any of the lists */
+int splice_list(size_t index, struct list_t *other, struct list_t *list);
+/* Moves the elements from the index to the end into a new list */
+struct list_t *split_list(size_t index, struct list_t *list);
+
+/* The number of runs merged at once when sorting, 2 to the number
+ * of bins runs can be sorted without walking the list again */
+#ifndef LIST_SORT_BINS
+#define LIST_SORT_BINS 64
+#endif
+
+/* Sorts the list using a compare function like the one of qsort, equal
+ * elements stay in their order. Only the links are changed, nothing is
+ * copied or allocated. Runs of elements already in order (or in reverse)
+ * are merged as they are, so a list that is almost sorted sorts quickly */
+int sort_list(int (*compare)(const void *, const void *), struct list_t *list);
+/* The context is given back to the compare function as the last argument */
+int sort_list_with_context(int (*compare)(const void *, const void *, void *),
+                           void *context, struct list_t *list);
+/* Moves the elements of the other sorted list into the sorted list in
+ * order, the lists must be able to splice. The elements of the list come
+ * first when equal. Both lists are walked once */
+int merge_list(struct list_t *other, int (*compare)(const void *, const void *),
+               struct list_t *list);
+/* Removes the elements equal to the element before them */
+int unique_list(int (*compare)(const void *, const void *), struct list_t *list);
+/* The element given second is removed right after compare returns 0 */
+int unique_list_with_context(int (*compare)(const void *, const void *, void *),
+                             void *context, struct list_t *list);
+
 int clear_list(struct list_t *list);
 int delete_list(struct list_t *list);
 
+/* An intrusive list links the elements you embed in your own structs, it
+ * never allocates or frees them. Link an element at an index and unlink
+ * it to get it back, clearing the list unlinks all of them. The data of
+ * an element is set to the element if it is NULL when linked, set it to
+ * your struct to sort the list or use container_of on the element.
+ * Adding elements to an intrusive list fails, since it does not allocate */
+int list_init_intrusive(struct list_t *list);
+int link_element(size_t index, struct element_t *element, struct list_t *list);
+struct element_t *unlink_element(size_t index, struct list_t *list);
+
+/* Pass the allocator of a pool to create_list_with_allocator,
+ * delete the pool after deleting the list that is using it */
+struct list_pool_t *create_list_pool(size_t typesize, size_t chunk_size);
+struct list_allocator_t get_list_pool_allocator(struct list_pool_t *pool);
+int delete_list_pool(struct list_pool_t *pool);
+
+/* These functions are not supposed to be used externally */
+void *allocate_pool_element(void *pool, size_t size);
+void deallocate_pool_element(void *pool, void *element, size_t size);
+void release_list_pool(void *pool);
+void *allocate_intrusive_element(void *context, size_t size);
+void deallocate_intrusive_element(void *context, void *element, size_t size);
+#ifdef LIST_STATS
+void register_list(struct list_t *list);
+void unregister_list(struct list_t *list);
+#endif
+int compare_list_data(const void *first, const void *second, void *compare);
+void **get_list_link(void *element, size_t next_offset);
+void *take_list_run(void **rest, size_t next_offset,
+                    int (*compare)(const void *, const void *, void *),
+                    void *context, void **last);
+void *merge_list_runs(void *left, void *left_last, void *right, void *right_last,
+                      size_t next_offset,
+                      int (*compare)(const void *, const void *, void *),
+                      void *context, void **last);
+void *sort_list_elements(void *first, size_t next_offset,
+                         int (*compare)(const void *, const void *, void *),
+                         void *context, void **last);
+
 #ifdef LIST_IMPL
 
 struct list_t *create_list(size_t typesize)
+{
+	return create_list_with_allocator(typesize, NULL);
+}
+
+struct list_t *create_list_with_allocator(size_t typesize,
+                                          const struct list_allocator_t *allocator)
 {
 	struct list_t *list = (struct list_t *) malloc(sizeof(struct list_t));
 
@@ -75,36 +314,96 @@ struct list_t *create_list(size_t typesize)
 		return NULL;
 	}
 
+	/* The base is in the list, so this is the only allocation */
+	list_init(typesize, allocator, list);
+	return list;
+}
+
+int list_init(size_t typesize, const struct list_allocator_t *allocator,
+              struct list_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+
+	list->tail = NULL;
+	list->cursor = NULL;
+	list->cursor_index = 0;
 	list->size = 0;
 	list->typesize = typesize;
-	list->base = (struct element_t *) malloc(sizeof(struct element_t));
-
-	if (!list->base) {
-		return NULL;
+	list->allocator.allocate = NULL;
+	list->allocator.deallocate = NULL;
+	list->allocator.release = NULL;
+	list->allocator.context = NULL;
+	if (allocator) {
+		list->allocator = *allocator;
 	}
+	list->base_element.data = NULL;
+	list->base_element.next = NULL;
+	list->base = &list->base_element;
+	list->entry = NULL;
+#ifdef LIST_STATS
+	register_list(list);
+#endif
+	return 0;
+}
 
-	list->base->data = NULL;
-	list->base->next = NULL;
-	return list;
+int list_destroy(struct list_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (clear_list(list)) {
+		return 2;
+	}
+#ifdef LIST_STATS
+	unregister_list(list);
+#endif
+	return 0;
 }
 
 struct element_t *get_element(size_t index, struct list_t *list)
 {
 	struct element_t *element = NULL;
+	size_t i = 0;
 
 	if (!list) {
 		return NULL;
 	}
-	element = list->base;
+	LIST_COUNT(list, gets, 1);
+
+	/* Index of -1 is the base, it is used
+	 * for getting the previous of index 0 */
+	if (index == (size_t) -1) {
+		return list->base;
+	}
+	if (index >= list->size) {
+		return NULL;
+	}
+	if (index == list->size - 1) {
+		return list->tail;
+	}
+
+	/* Continue from the last accessed element if it
+	 * is not past the index, else start from the base */
+	if (list->cursor && list->cursor_index <= index) {
+		element = list->cursor;
+		i = list->cursor_index;
+	} else {
+		element = (struct element_t *) list->base->next;
+	}
+	LIST_COUNT(list, walked, index - i);
+	LIST_TRACE_WALK(get_element, list, index, index - i);
 
-	/* Note, I am not using 'i <= index' because I want
-	 * the size to overflow in case the index was -1 */
-	for (size_t i = 0; i < (index + 1); i++) {
+	for (; i < index; i++) {
 		element = (struct element_t *) element->next;
 		if (!element) {
 			return NULL;
 		}
 	}
+
+	list->cursor = element;
+	list->cursor_index = index;
 	return element;
 }
 
@@ -118,15 +417,21 @@ int update_list_size(struct list_t *list)
 	if (!list) {
 		return 1;
 	}
+	if (!list->base) {
+		return 2;
+	}
 	element = list->base;
 
-	while (element) {
+	while (element->next) {
 		element = (struct element_t *) element->next;
 		size++;
 	}
 
 	/* The base is not considered as an element */
-	--size;
+	list->size = size;
+	list->tail = (element == list->base) ? NULL : element;
+	list->cursor = NULL;
+	list->cursor_index = 0;
 	return 0;
 }
 
@@ -135,32 +440,131 @@ size_t get_list_size(struct list_t *list)
 	if (!list) {
 		return 0;
 	}
-	if (update_list_size(list)) {
-		return 0;
-	}
 	return list->size;
 }
 
+#ifdef LIST_DEBUG
+int list_verify(struct list_t *list)
+{
+	struct element_t *element = NULL;
+	size_t size = 0;
+	int cursor_found = 0;
 
+	if (!list) {
+		return 1;
+	}
+	if (!list->base) {
+		return 2;
+	}
+	element = list->base;
+
+	/* Stop after the size is exceeded, in case the links have a loop */
+	while (element->next && size <= list->size) {
+		element = (struct element_t *) element->next;
+		if (!element->data) {
+			return 3;
+		}
+		if (element == list->cursor) {
+			if (list->cursor_index != size) {
+				return 4;
+			}
+			cursor_found = 1;
+		}
+		size++;
+	}
+
+	if (size != list->size) {
+		return 5;
+	}
+	if (list->tail != ((element == list->base) ? NULL : element)) {
+		return 6;
+	}
+	if (list->cursor && !cursor_found) {
+		return 4;
+	}
+	return 0;
+}
+#endif
+
+
+
+size_t align_data_offset(size_t offset, size_t typesize)
+{
+	size_t align = typesize & (~typesize + 1);
+
+	/* The alignment is the lowest set bit of the size */
+	if (!align || align > LIST_MAX_ALIGN) {
+		align = LIST_MAX_ALIGN;
+	}
+	return (offset + align - 1) & ~(align - 1);
+}
+
+size_t get_data_offset(size_t typesize)
+{
+	return align_data_offset(sizeof(struct element_t), typesize);
+}
 
 struct element_t *create_element(size_t typesize)
 {
-	struct element_t *element = (struct element_t *) malloc(sizeof(struct element_t));
+	size_t offset = get_data_offset(typesize);
+	struct element_t *element = (struct element_t *) malloc(offset + typesize);
+
 	if (!element) {
 		return NULL;
 	}
 
 	element->next = NULL;
-	element->data = malloc(typesize);
+	element->data = (void *) ((char *) element + offset);
+	return element;
+}
+
+int delete_element(struct element_t *element)
+{
+	if (!element) {
+		return 1;
+	}
 	if (!element->data) {
+		return 2;
+	}
+
+	/* The data is freed along with the element */
+	free(element);
+	return 0;
+}
+
+struct element_t *create_list_element(struct list_t *list)
+{
+	struct element_t *element = NULL;
+	size_t offset = 0;
+
+	if (!list) {
+		return NULL;
+	}
+	offset = get_data_offset(list->typesize);
+	if (!list->allocator.allocate) {
+		element = create_element(list->typesize);
+	} else {
+		element = (struct element_t *) list->allocator.allocate(
+		                  list->allocator.context, offset + list->typesize);
+		if (element) {
+			element->next = NULL;
+			element->data = (void *) ((char *) element + offset);
+		}
+	}
+	if (!element) {
 		return NULL;
 	}
 
+	LIST_COUNT(list, allocations, 1);
+	LIST_COUNT(list, allocated_bytes, offset + list->typesize);
 	return element;
 }
 
-int delete_element(struct element_t *element)
+int delete_list_element(struct element_t *element, struct list_t *list)
 {
+	if (!list) {
+		return 1;
+	}
 	if (!element) {
 		return 1;
 	}
@@ -168,8 +572,18 @@ int delete_element(struct element_t *element)
 		return 2;
 	}
 
-	free(element->data);
-	free(element);
+	if (!list->allocator.deallocate) {
+		delete_element(element);
+	} else {
+		list->allocator.deallocate(list->allocator.context, element,
+		                           get_data_offset(list->typesize) + list->typesize);
+	}
+
+	/* The elements of an intrusive list are not freed */
+	if (list->allocator.deallocate != deallocate_intrusive_element) {
+		LIST_COUNT(list, frees, 1);
+		LIST_COUNT(list, freed_bytes, get_data_offset(list->typesize) + list->typesize);
+	}
 	return 0;
 }
 
@@ -179,7 +593,6 @@ struct element_t *add_element(size_t index, struct list_t *list)
 {
 	struct element_t *new_element = NULL;
 	struct element_t *prev = NULL;
-	struct element_t *temp = NULL;
 
 	if (!list) {
 		return NULL;
@@ -188,30 +601,104 @@ struct element_t *add_element(size_t index, struct list_t *list)
 		return NULL;
 	}
 
+	/* Adding at the end gets the tail, no walking is done */
 	prev = get_element(index - 1, list);
-	new_element = create_element(list->typesize);
 
 	/* There can't be no previous because the base should exist */
 	if (!prev) {
 		return NULL;
 	}
+
+	new_element = create_list_element(list);
 	if (!new_element) {
 		return NULL;
 	}
 
-	temp = (struct element_t *) prev->next;
+	new_element->next = prev->next;
 	prev->next = (void *) new_element;
-	new_element->next = (void *) temp;
+	if (!new_element->next) {
+		list->tail = new_element;
+	}
+
+	/* The elements after the index have moved, so
+	 * the new element becomes the last accessed */
+	list->cursor = new_element;
+	list->cursor_index = index;
 
 	list->size++;
+	LIST_COUNT(list, adds, 1);
+	LIST_COUNT_SIZE(list);
+	LIST_TRACE(add_element, list, index);
 	return new_element;
 }
 
+int link_element(size_t index, struct element_t *element, struct list_t *list)
+{
+	struct element_t *prev = NULL;
+
+	if (!list || !element) {
+		return 1;
+	}
+	if (index > list->size) {
+		return 3;
+	}
+
+	prev = get_element(index - 1, list);
+	if (!prev) {
+		return 5;
+	}
+	if (!element->data) {
+		element->data = (void *) element;
+	}
+
+	element->next = prev->next;
+	prev->next = (void *) element;
+	if (!element->next) {
+		list->tail = element;
+	}
+
+	list->cursor = element;
+	list->cursor_index = index;
+
+	list->size++;
+	LIST_COUNT(list, adds, 1);
+	LIST_COUNT_SIZE(list);
+	return 0;
+}
+
+struct element_t *unlink_element(size_t index, struct list_t *list)
+{
+	struct element_t *element = NULL;
+	struct element_t *prev = NULL;
+
+	if (!list || index >= list->size) {
+		return NULL;
+	}
+
+	prev = get_element(index - 1, list);
+	if (!prev || !prev->next) {
+		return NULL;
+	}
+	element = (struct element_t *) prev->next;
+
+	prev->next = element->next;
+	if (list->tail == element) {
+		list->tail = (prev == list->base) ? NULL : prev;
+	}
+
+	list->cursor = (prev == list->base) ? NULL : prev;
+	list->cursor_index = index - 1;
+
+	element->next = NULL;
+	list->size--;
+	LIST_COUNT(list, removes, 1);
+	return element;
+}
+
 int remove_element(size_t index, struct list_t *list)
 {
 	struct element_t *element = NULL;
 	struct element_t *prev = NULL;
-	struct element_t *next = NULL;
 
 	if (!list) {
 		return 1;
@@ -220,36 +707,323 @@ int remove_element(size_t index, struct list_t *list)
 		return 3;
 	}
 
-	element = get_element(index, list);
+	prev = get_element(index - 1, list);
+	if (!prev) {
+		return 5;
+	}
+	element = (struct element_t *) prev->next;
 	if (!element) {
 		return 4;
 	}
+
+	prev->next = element->next;
+	if (list->tail == element) {
+		list->tail = (prev == list->base) ? NULL : prev;
+	}
+
+	/* The previous element keeps its index, the base is not cached */
+	list->cursor = (prev == list->base) ? NULL : prev;
+	list->cursor_index = index - 1;
+
+	if (delete_list_element(element, list)) {
+		return 6;
+	}
+	list->size--;
+	LIST_COUNT(list, removes, 1);
+	LIST_TRACE(remove_element, list, index);
+
+	return 0;
+}
+
+struct element_t *add_elements(size_t index, const void *data, size_t count,
+                               struct list_t *list)
+{
+	struct element_t *first = NULL;
+	struct element_t *last = NULL;
+	struct element_t *element = NULL;
+	struct element_t *prev = NULL;
+	size_t i = 0;
+
+	if (!list) {
+		return NULL;
+	}
+	if (index > list->size || count == 0) {
+		return NULL;
+	}
+
 	prev = get_element(index - 1, list);
+	if (!prev) {
+		return NULL;
+	}
+
+	/* The elements are linked to each other before they are added,
+	 * so that the list is left as it was if one can't be allocated */
+	for (i = 0; i < count; i++) {
+		element = create_list_element(list);
+		if (!element) {
+			while (first) {
+				element = (struct element_t *) first->next;
+				delete_list_element(first, list);
+				first = element;
+			}
+			return NULL;
+		}
+		if (data) {
+			memcpy(element->data, (const char *) data
+			       + i * list->typesize, list->typesize);
+		}
+		if (last) {
+			last->next = (void *) element;
+		} else {
+			first = element;
+		}
+		last = element;
+	}
+
+	last->next = prev->next;
+	prev->next = (void *) first;
+	if (!last->next) {
+		list->tail = last;
+	}
+
+	list->cursor = last;
+	list->cursor_index = index + count - 1;
 
-	/* To prevent unnecessary error logs, I used an 'if' check */
-	if (index < list->size - 1) {
-		next = get_element(index + 1, list);
+	list->size += count;
+	LIST_COUNT(list, adds, count);
+	LIST_COUNT_SIZE(list);
+	return first;
+}
+
+int remove_elements(size_t index, size_t count, struct list_t *list)
+{
+	struct element_t *element = NULL;
+	struct element_t *next = NULL;
+	struct element_t *prev = NULL;
+	size_t i = 0;
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+	if (count == 0) {
+		return 0;
 	}
+	if (index >= list->size || count > list->size - index) {
+		return 3;
+	}
+
+	prev = get_element(index - 1, list);
 	if (!prev) {
 		return 5;
 	}
 
-	prev->next = NULL;
-	if (next) {
-		prev->next = next;
+	/* The removed elements are unlinked all at once */
+	element = (struct element_t *) prev->next;
+	for (i = 0; i < count; i++) {
+		if (!element) {
+			return 4;
+		}
+		next = (struct element_t *) element->next;
+		if (delete_list_element(element, list)) {
+			error = 6;
+		}
+		element = next;
 	}
-	if (delete_element(element)) {
-		return 6;
+
+	prev->next = (void *) element;
+	if (!element) {
+		list->tail = (prev == list->base) ? NULL : prev;
 	}
-	list->size--;
 
+	list->cursor = (prev == list->base) ? NULL : prev;
+	list->cursor_index = index - 1;
+
+	list->size -= count;
+	LIST_COUNT(list, removes, count);
+	return error;
+}
+
+int splice_list(size_t index, struct list_t *other, struct list_t *list)
+{
+	struct element_t *prev = NULL;
+
+	if (!list || !other) {
+		return 1;
+	}
+	if (index > list->size) {
+		return 3;
+	}
+
+	/* The elements are freed by the allocator of the list after moving,
+	 * a pool frees the elements of its own list only when clearing it */
+	if (other == list || other->typesize != list->typesize
+	    || other->allocator.allocate != list->allocator.allocate
+	    || other->allocator.deallocate != list->allocator.deallocate
+	    || other->allocator.release || list->allocator.release) {
+		return 2;
+	}
+	if (other->size == 0) {
+		return 0;
+	}
+
+	prev = get_element(index - 1, list);
+	if (!prev) {
+		return 5;
+	}
+
+	other->tail->next = prev->next;
+	prev->next = other->base->next;
+	if (!other->tail->next) {
+		list->tail = other->tail;
+	}
+
+	list->cursor = other->tail;
+	list->cursor_index = index + other->size - 1;
+	list->size += other->size;
+	LIST_COUNT_SIZE(list);
+
+	other->base->next = NULL;
+	other->tail = NULL;
+	other->cursor = NULL;
+	other->cursor_index = 0;
+	other->size = 0;
+	return 0;
+}
+
+struct list_t *split_list(size_t index, struct list_t *list)
+{
+	struct list_t *split = NULL;
+	struct element_t *prev = NULL;
+
+	if (!list) {
+		return NULL;
+	}
+	if (index > list->size || list->allocator.release) {
+		return NULL;
+	}
+
+	prev = get_element(index - 1, list);
+	if (!prev) {
+		return NULL;
+	}
+	split = create_list_with_allocator(list->typesize,
+	                                   list->allocator.allocate ? &list->allocator : NULL);
+	if (!split) {
+		return NULL;
+	}
+
+	/* Nothing is moved when splitting at the end */
+	if (index < list->size) {
+		split->base->next = prev->next;
+		split->tail = list->tail;
+		split->size = list->size - index;
+
+		prev->next = NULL;
+		list->tail = (prev == list->base) ? NULL : prev;
+		list->size = index;
+	}
+
+	list->cursor = (prev == list->base) ? NULL : prev;
+	list->cursor_index = index - 1;
+	return split;
+}
+
+int sort_list(int (*compare)(const void *, const void *), struct list_t *list)
+{
+	if (!compare) {
+		return 1;
+	}
+	return sort_list_with_context(compare_list_data, (void *) &compare, list);
+}
+
+int sort_list_with_context(int (*compare)(const void *, const void *, void *),
+                           void *context, struct list_t *list)
+{
+	void *last = NULL;
+
+	if (!list || !compare) {
+		return 1;
+	}
+	if (list->size < 2) {
+		return 0;
+	}
+
+	list->base->next = sort_list_elements(list->base->next,
+	                                      offsetof(struct element_t, next),
+	                                      compare, context, &last);
+	list->tail = (struct element_t *) last;
+	list->cursor = NULL;
+	list->cursor_index = 0;
 	return 0;
 }
 
+int merge_list(struct list_t *other, int (*compare)(const void *, const void *),
+               struct list_t *list)
+{
+	int error = 0;
+
+	if (!list || !other || !compare) {
+		return 1;
+	}
+
+	/* The other list follows the list, so there are two runs to merge */
+	error = splice_list(list->size, other, list);
+	if (error) {
+		return error;
+	}
+	return sort_list(compare, list);
+}
+
+int unique_list(int (*compare)(const void *, const void *), struct list_t *list)
+{
+	if (!compare) {
+		return 1;
+	}
+	return unique_list_with_context(compare_list_data, (void *) &compare, list);
+}
+
+int unique_list_with_context(int (*compare)(const void *, const void *, void *),
+                             void *context, struct list_t *list)
+{
+	struct element_t *element = NULL;
+	struct element_t *next = NULL;
+	int error = 0;
+
+	if (!list || !compare) {
+		return 1;
+	}
+	if (list->size < 2) {
+		return 0;
+	}
+
+	element = (struct element_t *) list->base->next;
+	while ((next = (struct element_t *) element->next)) {
+		if (compare(element->data, next->data, context) == 0) {
+			element->next = next->next;
+			if (delete_list_element(next, list)) {
+				error = 2;
+			}
+			list->size--;
+		} else {
+			element = next;
+		}
+	}
+
+	list->tail = element;
+	list->cursor = NULL;
+	list->cursor_index = 0;
+	return error;
+}
+
 
 
 int clear_list(struct list_t *list)
 {
+	struct element_t *element = NULL;
+	struct element_t *next = NULL;
+	int error = 0;
+
 	if (!list) {
 		return 1;
 	}
@@ -258,10 +1032,30 @@ int clear_list(struct list_t *list)
 		return 0;
 	}
 
-	for (int i = list->size - 1; i >= 0; i--) {
-		remove_element(i, list);
+	/* The allocator can free all the elements at once,
+	 * otherwise every element is deleted in a single pass */
+	if (list->allocator.release) {
+		list->allocator.release(list->allocator.context);
+		LIST_COUNT(list, frees, list->size);
+		LIST_COUNT(list, freed_bytes, list->size
+		           * (get_data_offset(list->typesize) + list->typesize));
+	} else {
+		element = (struct element_t *) list->base->next;
+		while (element) {
+			next = (struct element_t *) element->next;
+			if (delete_list_element(element, list)) {
+				error = 2;
+			}
+			element = next;
+		}
 	}
-	return 0;
+
+	list->base->next = NULL;
+	list->tail = NULL;
+	list->cursor = NULL;
+	list->cursor_index = 0;
+	list->size = 0;
+	return error;
 }
 
 int delete_list(struct list_t *list)
@@ -269,18 +1063,394 @@ int delete_list(struct list_t *list)
 	if (!list) {
 		return 1;
 	}
-	if (clear_list(list)) {
+	if (list_destroy(list)) {
 		return 2;
 	}
-	if (!list->base) {
-		return 3;
-	}
 
-	free(list->base);
 	free(list);
 	return 0;
 }
 
+int list_init_intrusive(struct list_t *list)
+{
+	struct list_allocator_t allocator;
+
+	allocator.allocate = allocate_intrusive_element;
+	allocator.deallocate = deallocate_intrusive_element;
+	allocator.release = NULL;
+	allocator.context = NULL;
+	return list_init(0, &allocator, list);
+}
+
+
+
+struct list_pool_t *create_list_pool(size_t typesize, size_t chunk_size)
+{
+	struct list_pool_t *pool = NULL;
+	size_t element_size = get_data_offset(typesize) + typesize;
+
+	if (chunk_size == 0) {
+		return NULL;
+	}
+	pool = (struct list_pool_t *) malloc(sizeof(struct list_pool_t));
+	if (!pool) {
+		return NULL;
+	}
+
+	/* Every element in a chunk has to be aligned, and must be
+	 * large enough to link it in the list of removed elements */
+	if (element_size < sizeof(void *)) {
+		element_size = sizeof(void *);
+	}
+	element_size = (element_size + LIST_MAX_ALIGN - 1) & ~(LIST_MAX_ALIGN - 1);
+
+	pool->chunks = NULL;
+	pool->free = NULL;
+	pool->next = NULL;
+	pool->remaining = 0;
+	pool->element_size = element_size;
+	pool->chunk_size = chunk_size;
+	return pool;
+}
+
+struct list_allocator_t get_list_pool_allocator(struct list_pool_t *pool)
+{
+	struct list_allocator_t allocator;
+
+	allocator.allocate = allocate_pool_element;
+	allocator.deallocate = deallocate_pool_element;
+	allocator.release = release_list_pool;
+	allocator.context = (void *) pool;
+	return allocator;
+}
+
+int delete_list_pool(struct list_pool_t *pool)
+{
+	if (!pool) {
+		return 1;
+	}
+
+	release_list_pool(pool);
+	free(pool);
+	return 0;
+}
+
+void *allocate_pool_element(void *pool, size_t size)
+{
+	struct list_pool_t *list_pool = (struct list_pool_t *) pool;
+	void *element = NULL;
+	void *chunk = NULL;
+
+	if (!list_pool || size > list_pool->element_size) {
+		return NULL;
+	}
+
+	/* Reuse a removed element first */
+	if (list_pool->free) {
+		element = list_pool->free;
+		list_pool->free = *(void **) element;
+		return element;
+	}
+
+	/* The first element of a chunk is used to link the chunks */
+	if (list_pool->remaining == 0) {
+		chunk = malloc(list_pool->element_size * (list_pool->chunk_size + 1));
+		if (!chunk) {
+			return NULL;
+		}
+		*(void **) chunk = list_pool->chunks;
+		list_pool->chunks = chunk;
+		list_pool->next = (char *) chunk + list_pool->element_size;
+		list_pool->remaining = list_pool->chunk_size;
+	}
+
+	element = (void *) list_pool->next;
+	list_pool->next += list_pool->element_size;
+	list_pool->remaining--;
+	return element;
+}
+
+void deallocate_pool_element(void *pool, void *element, size_t size)
+{
+	struct list_pool_t *list_pool = (struct list_pool_t *) pool;
+
+	(void) size;
+	if (!list_pool || !element) {
+		return;
+	}
+
+	*(void **) element = list_pool->free;
+	list_pool->free = element;
+}
+
+void release_list_pool(void *pool)
+{
+	struct list_pool_t *list_pool = (struct list_pool_t *) pool;
+	void *chunk = NULL;
+
+	if (!list_pool) {
+		return;
+	}
+
+	while (list_pool->chunks) {
+		chunk = list_pool->chunks;
+		list_pool->chunks = *(void **) chunk;
+		free(chunk);
+	}
+	list_pool->free = NULL;
+	list_pool->next = NULL;
+	list_pool->remaining = 0;
+}
+
+void *allocate_intrusive_element(void *context, size_t size)
+{
+	/* The elements of an intrusive list are linked, not added */
+	(void) context;
+	(void) size;
+	return NULL;
+}
+
+void deallocate_intrusive_element(void *context, void *element, size_t size)
+{
+	/* Removing an element only unlinks it, it belongs to you */
+	(void) context;
+	(void) element;
+	(void) size;
+}
+
+#ifdef LIST_STATS
+struct list_entry_t *list_registry = NULL;
+pthread_mutex_t list_registry_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+int list_get_stats(struct list_stats_t *stats, struct list_t *list)
+{
+	if (!stats || !list) {
+		return 1;
+	}
+	if (!list->entry) {
+		return 2;
+	}
+	*stats = list->entry->stats;
+	return 0;
+}
+
+int list_reset_stats(struct list_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (!list->entry) {
+		return 2;
+	}
+
+	/* The list is as long as the longest it is from now on */
+	memset(&list->entry->stats, 0, sizeof(list->entry->stats));
+	list->entry->stats.max_size = list->size;
+	return 0;
+}
+
+int list_dump_stats(FILE *file)
+{
+	struct list_entry_t *entry = NULL;
+	struct list_t *list = NULL;
+	struct list_stats_t *stats = NULL;
+
+	if (!file) {
+		return 1;
+	}
+
+	pthread_mutex_lock(&list_registry_mutex);
+	fprintf(file, "[");
+	for (entry = list_registry; entry; entry = entry->next) {
+		list = entry->list;
+		stats = &entry->stats;
+		fprintf(file, "%s\n  {\"list\": \"%p\", \"size\": %zu, \"typesize\": %zu, "
+		        "\"adds\": %zu, \"removes\": %zu, \"gets\": %zu, \"walked\": %zu, "
+		        "\"average_walk\": %.2f, \"allocations\": %zu, \"frees\": %zu, "
+		        "\"allocated_bytes\": %zu, \"freed_bytes\": %zu, \"max_size\": %zu}",
+		        entry == list_registry ? "" : ",", (void *) list, list->size,
+		        list->typesize, stats->adds, stats->removes, stats->gets,
+		        stats->walked, stats->gets ? (double) stats->walked / stats->gets : 0.0,
+		        stats->allocations, stats->frees, stats->allocated_bytes,
+		        stats->freed_bytes, stats->max_size);
+	}
+	fprintf(file, list_registry ? "\n]\n" : "]\n");
+	pthread_mutex_unlock(&list_registry_mutex);
+	return ferror(file) ? 2 : 0;
+}
+
+void register_list(struct list_t *list)
+{
+	struct list_entry_t *entry = NULL;
+
+	/* The list works without its entry, it is only not counted */
+	entry = (struct list_entry_t *) calloc(1, sizeof(struct list_entry_t));
+	if (!entry) {
+		return;
+	}
+	entry->list = list;
+	list->entry = entry;
+
+	pthread_mutex_lock(&list_registry_mutex);
+	entry->next = list_registry;
+	if (list_registry) {
+		list_registry->prev = entry;
+	}
+	list_registry = entry;
+	pthread_mutex_unlock(&list_registry_mutex);
+}
+
+void unregister_list(struct list_t *list)
+{
+	struct list_entry_t *entry = list->entry;
+
+	if (!entry) {
+		return;
+	}
+
+	pthread_mutex_lock(&list_registry_mutex);
+	if (entry->prev) {
+		entry->prev->next = entry->next;
+	} else {
+		list_registry = entry->next;
+	}
+	if (entry->next) {
+		entry->next->prev = entry->prev;
+	}
+	pthread_mutex_unlock(&list_registry_mutex);
+
+	list->entry = NULL;
+	free(entry);
+}
+#endif
+
+int compare_list_data(const void *first, const void *second, void *compare)
+{
+	/* The context is the compare function without a context */
+	return (*(int (**)(const void *, const void *)) compare)(first, second);
+}
+
+void **get_list_link(void *element, size_t next_offset)
+{
+	return (void **) ((char *) element + next_offset);
+}
+
+/* The elements of the lists start with the pointer to their data, and the
+ * next is found at the offset, so that sorting works for both lists */
+void *take_list_run(void **rest, size_t next_offset,
+                    int (*compare)(const void *, const void *, void *),
+                    void *context, void **last)
+{
+	void *first = *rest;
+	void *element = first;
+	void *next = *get_list_link(first, next_offset);
+	void *after = NULL;
+
+	/* A run going down is reversed while it is taken. It must be strictly
+	 * going down, so that equal elements are not reversed */
+	if (next && compare(*(void **) first, *(void **) next, context) > 0) {
+		*get_list_link(first, next_offset) = NULL;
+		while (next && compare(*(void **) element, *(void **) next, context) > 0) {
+			after = *get_list_link(next, next_offset);
+			*get_list_link(next, next_offset) = element;
+			element = next;
+			next = after;
+		}
+		*rest = next;
+		*last = first;
+		return element;
+	}
+
+	while (next && compare(*(void **) element, *(void **) next, context) <= 0) {
+		element = next;
+		next = *get_list_link(next, next_offset);
+	}
+	*get_list_link(element, next_offset) = NULL;
+	*rest = next;
+	*last = element;
+	return first;
+}
+
+void *merge_list_runs(void *left, void *left_last, void *right, void *right_last,
+                      size_t next_offset,
+                      int (*compare)(const void *, const void *, void *),
+                      void *context, void **last)
+{
+	void *merged = NULL;
+	void **link = &merged;
+
+	/* The left is taken when equal to keep the order of equal elements */
+	while (left && right) {
+		if (compare(*(void **) left, *(void **) right, context) > 0) {
+			*link = right;
+			link = get_list_link(right, next_offset);
+			right = *link;
+		} else {
+			*link = left;
+			link = get_list_link(left, next_offset);
+			left = *link;
+		}
+	}
+	*link = left ? left : right;
+	*last = left ? left_last : right_last;
+	return merged;
+}
+
+void *sort_list_elements(void *first, size_t next_offset,
+                         int (*compare)(const void *, const void *, void *),
+                         void *context, void **last)
+{
+	/* The runs are merged like a binary counter counts, a run in the
+	 * bin of k is made of 2 to the k runs. The runs are merged while
+	 * they are still in the cache instead of walking the list again */
+	void *bins[LIST_SORT_BINS];
+	void *bin_lasts[LIST_SORT_BINS];
+	void *run = NULL;
+	void *run_last = NULL;
+	void *rest = first;
+	size_t used = 0;
+	size_t i = 0;
+
+	while (rest) {
+		run = take_list_run(&rest, next_offset, compare, context, &run_last);
+
+		/* The runs in the bins come before the run, so they are the left.
+		 * The last bin keeps the runs merged into it */
+		i = 0;
+		while (i < used && bins[i]) {
+			run = merge_list_runs(bins[i], bin_lasts[i], run, run_last,
+			                      next_offset, compare, context, &run_last);
+			bins[i] = NULL;
+			if (i + 1 == LIST_SORT_BINS) {
+				break;
+			}
+			i++;
+		}
+		if (i == used) {
+			used++;
+		}
+		bins[i] = run;
+		bin_lasts[i] = run_last;
+	}
+
+	/* The bins of the higher runs hold the elements before */
+	run = NULL;
+	for (i = 0; i < used; i++) {
+		if (!bins[i]) {
+			continue;
+		}
+		if (run) {
+			run = merge_list_runs(bins[i], bin_lasts[i], run, run_last,
+			                      next_offset, compare, context, &run_last);
+		} else {
+			run = bins[i];
+			run_last = bin_lasts[i];
+		}
+	}
+	*last = run_last;
+	return run;
+}
+
 /* LIST_IMPL */
 #endif
 
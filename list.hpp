@@ -30,180 +30,1280 @@
 // This header is just a wrapper for the Minimal C Linked List
 #include "list.h"
 
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
 namespace aplib
 {
-template<typename type_t>
+// A backend stores the elements of a list, it wraps one of the C lists to
+// give the list and its iterators the same interface. Positions are used
+// by the iterators, the end position comes after the last element
+struct singly_linked
+{
+	using internal_t = list_t;
+	using position_t = element_t *;
+	using iterator_category = std::forward_iterator_tag;
+	// Elements stay where they are allocated
+	static constexpr bool moves_elements = false;
+
+	static internal_t *create(size_t typesize,
+	                          const list_allocator_t *allocator);
+	static int destroy(internal_t *list);
+	static int clear(internal_t *list);
+	static size_t size(internal_t *list);
+
+	static void *get(size_t index, internal_t *list);
+	static void *add(size_t index, internal_t *list);
+	static int remove(size_t index, internal_t *list);
+	// Removing count elements at the index walking the list once,
+	// their values are destroyed before
+	static int remove(size_t index, size_t count, internal_t *list);
+
+	static position_t begin(internal_t *list);
+	static position_t end(internal_t *list);
+	static position_t next(position_t position);
+	static void *data(position_t position);
+
+	// Adding before a position and removing at a position walk
+	// the list to find the previous element of the position
+	static position_t insert(position_t position, internal_t *list);
+	static position_t erase(position_t position, internal_t *list);
+
+	// Moving the elements of another list to an index and the elements
+	// from an index to a new list, the lists use the same allocator
+	static int splice(size_t index, internal_t *other, internal_t *list);
+	static internal_t *split(size_t index, internal_t *list);
+	// Sorting relinks the elements, the compare is like the one of qsort
+	static int sort(int (*compare)(const void *, const void *, void *),
+	                void *context, internal_t *list);
+	// Removing the elements the compare gives 0 for with the one kept
+	// before them, the removed ones are unlinked without moving values
+	static int unique(int (*compare)(const void *, const void *, void *),
+	                  void *context, internal_t *list);
+
+	// The position of an index, the end if it is past the last element.
+	// Finding increasing indices continues from the last one found
+	static position_t find(size_t index, internal_t *list);
+};
+
+template<typename type_t, typename alloc_t = std::allocator<type_t>,
+         typename backend_t = singly_linked>
 class list
 {
+	// Backends moving elements in memory copy their bytes
+	static_assert(!backend_t::moves_elements
+	              || std::is_trivially_copyable<type_t>::value,
+	              "The backend moves elements, the type must be trivially copyable");
 public:
 	class iterator;
+	class const_iterator;
+	using allocator_type = alloc_t;
 private:
-	list_t *internal_list;
+	// Elements are allocated in units of the maximum alignment, so
+	// that allocators aligning for the type (like pmr) work as well
+	using element_alloc_t = typename std::allocator_traits<alloc_t>::
+	                        template rebind_alloc<std::max_align_t>;
+
+	using internal_t = typename backend_t::internal_t;
+	using position_t = typename backend_t::position_t;
+
+	element_alloc_t allocator;
+	internal_t *internal_list;
+
+	static void *allocate_element(void *context, size_t size);
+	static void deallocate_element(void *context, void *pointer, size_t size);
+	void create_internal_list();
+	void delete_internal_list();
+
+	// The compare of sort and the predicate of unique are given to the
+	// backend through the context
+	template<typename compare_t>
+	struct sort_context
+	{
+		compare_t *compare;
+		std::exception_ptr error;
+	};
+	template<typename compare_t>
+	static int unique_values(const void *first, const void *second,
+	                         void *context);
+	template<typename compare_t>
+	static int compare_values(const void *first, const void *second,
+	                          void *context);
 public:
 
 	list();
+	explicit list(const alloc_t &allocator);
+	list(const list &other);
+	list(list &&other) noexcept;
 	~list();
 
-	list<type_t> &insert(size_t index);
-	list<type_t> &insert(size_t index, type_t value);
-	list<type_t> &erase(size_t index);
+	list<type_t, alloc_t, backend_t> &operator=(const list &other);
+	list<type_t, alloc_t, backend_t> &operator=(list &&other) noexcept(
+	        std::allocator_traits<alloc_t>::
+	        propagate_on_container_move_assignment::value);
+	void swap(list &other) noexcept;
+
+	alloc_t get_allocator() const;
+
+	// Values are constructed in place from the arguments
+	template<typename... args_t>
+	type_t &emplace(size_t index, args_t &&... args);
+	template<typename... args_t>
+	type_t &emplace_front(args_t &&... args);
+	template<typename... args_t>
+	type_t &emplace_back(args_t &&... args);
+
+	list<type_t, alloc_t, backend_t> &insert(size_t index);
+	list<type_t, alloc_t, backend_t> &insert(size_t index, const type_t &value);
+	list<type_t, alloc_t, backend_t> &insert(size_t index, type_t &&value);
+	list<type_t, alloc_t, backend_t> &erase(size_t index);
+
+	// Ranges of values are added and removed walking the list once
+	template<typename input_t, typename = typename
+	         std::iterator_traits<input_t>::iterator_category>
+	list<type_t, alloc_t, backend_t> &insert(size_t index, input_t first,
+	                                         input_t last);
+	list<type_t, alloc_t, backend_t> &erase(size_t index, size_t count);
+
+	// The elements of the other list are moved to the index, they are
+	// moved one by one only if the allocators of the lists are not equal
+	list<type_t, alloc_t, backend_t> &splice(size_t index, list &other);
+	// The elements from the index to the end are moved to a new list
+	list<type_t, alloc_t, backend_t> split(size_t index);
 
-	size_t size();
+	// Sorting keeps equal values in their order, linked backends relink
+	// their elements and the others copy them. If the compare throws, the
+	// list is left in some order and the exception is thrown again
+	list<type_t, alloc_t, backend_t> &sort();
+	template<typename compare_t>
+	list<type_t, alloc_t, backend_t> &sort(compare_t compare);
+	// The values of the other sorted list are moved into the sorted list in
+	// order, the values of the list come first when equal
+	list<type_t, alloc_t, backend_t> &merge(list &other);
+	template<typename compare_t>
+	list<type_t, alloc_t, backend_t> &merge(list &other, compare_t compare);
+	// Removes the values equal to the value before them, linked backends
+	// unlink the removed elements and the others copy the kept ones down
+	list<type_t, alloc_t, backend_t> &unique();
+	template<typename predicate_t>
+	list<type_t, alloc_t, backend_t> &unique(predicate_t predicate);
+
+	size_t size() const;
 	type_t &at(size_t index);
-	list<type_t> &clear();
+	type_t &front();
+	type_t &back();
+	list<type_t, alloc_t, backend_t> &clear();
+
+	list<type_t, alloc_t, backend_t> &push_back();
+	list<type_t, alloc_t, backend_t> &push_back(const type_t &value);
+	list<type_t, alloc_t, backend_t> &push_back(type_t &&value);
+	list<type_t, alloc_t, backend_t> &pop_back();
 
-	list<type_t> &push_back();
-	list<type_t> &push_back(type_t value);
-	list<type_t> &pop_back();
+	list<type_t, alloc_t, backend_t> &push_front();
+	list<type_t, alloc_t, backend_t> &push_front(const type_t &value);
+	list<type_t, alloc_t, backend_t> &push_front(type_t &&value);
+	list<type_t, alloc_t, backend_t> &pop_front();
 
+	// Iterators hold the position of an element in the backend and
+	// move through it, they can move back if the backend allows it
 	class iterator
 	{
-		list_t *list;
-		size_t index;
+		position_t position;
 	public:
-		iterator(list_t *internal_list);
-		iterator() = default;
+		using iterator_category = typename backend_t::iterator_category;
+		using value_type = type_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = type_t *;
+		using reference = type_t &;
+
+		explicit iterator(position_t position);
+		iterator();
 
 		iterator &operator++();
-		bool operator!=(const iterator &compare);
-		type_t &operator*();
+		iterator operator++(int);
+		iterator &operator--();
+		iterator operator--(int);
+		bool operator==(const iterator &compare) const;
+		bool operator!=(const iterator &compare) const;
+		type_t &operator*() const;
+		type_t *operator->() const;
 
 		friend class list;
+		friend class const_iterator;
 	};
 	friend class iterator;
 
+	class const_iterator
+	{
+		position_t position;
+	public:
+		using iterator_category = typename backend_t::iterator_category;
+		using value_type = type_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const type_t *;
+		using reference = const type_t &;
+
+		explicit const_iterator(position_t position);
+		const_iterator(const iterator &other);
+		const_iterator();
+
+		const_iterator &operator++();
+		const_iterator operator++(int);
+		const_iterator &operator--();
+		const_iterator operator--(int);
+		bool operator==(const const_iterator &compare) const;
+		bool operator!=(const const_iterator &compare) const;
+		const type_t &operator*() const;
+		const type_t *operator->() const;
+
+		friend class list;
+	};
+	friend class const_iterator;
+
 	iterator begin();
 	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+
+	// The iterator of an index, the end if it is past the last element
+	iterator nth(size_t index);
+	const_iterator nth(size_t index) const;
+
+	// Adding and removing at an iterator does not walk the list
+	// if the backend is doubly linked, the others have to walk
+	template<typename... args_t>
+	iterator emplace(const_iterator position, args_t &&... args);
+	iterator insert(const_iterator position, const type_t &value);
+	iterator insert(const_iterator position, type_t &&value);
+	iterator erase(const_iterator position);
 
 	type_t &operator[](size_t index);
+
+	// The list of the backend, for the functions working on it directly
+	using native_handle_type = internal_t *;
+	native_handle_type native_handle() const;
 };
 }
 
 #ifdef LIST_IMPL
 
-template<typename type_t>
-aplib::list<type_t>::list()
+aplib::singly_linked::internal_t *aplib::singly_linked::create(size_t typesize,
+        const list_allocator_t *allocator)
+{
+	return create_list_with_allocator(typesize, allocator);
+}
+
+int aplib::singly_linked::destroy(internal_t *list)
+{
+	return delete_list(list);
+}
+
+int aplib::singly_linked::clear(internal_t *list)
+{
+	return clear_list(list);
+}
+
+size_t aplib::singly_linked::size(internal_t *list)
+{
+	return get_list_size(list);
+}
+
+void *aplib::singly_linked::get(size_t index, internal_t *list)
+{
+	element_t *element = get_element(index, list);
+	return element ? element->data : nullptr;
+}
+
+void *aplib::singly_linked::add(size_t index, internal_t *list)
+{
+	element_t *element = add_element(index, list);
+	return element ? element->data : nullptr;
+}
+
+int aplib::singly_linked::remove(size_t index, internal_t *list)
+{
+	return remove_element(index, list);
+}
+
+int aplib::singly_linked::remove(size_t index, size_t count, internal_t *list)
+{
+	return remove_elements(index, count, list);
+}
+
+aplib::singly_linked::position_t aplib::singly_linked::begin(internal_t *list)
+{
+	return (element_t *) list->base->next;
+}
+
+aplib::singly_linked::position_t aplib::singly_linked::end(internal_t *list)
+{
+	(void) list;
+	return nullptr;
+}
+
+aplib::singly_linked::position_t aplib::singly_linked::next(position_t position)
+{
+	return (element_t *) position->next;
+}
+
+void *aplib::singly_linked::data(position_t position)
+{
+	return position->data;
+}
+
+aplib::singly_linked::position_t aplib::singly_linked::insert(position_t position,
+        internal_t *list)
+{
+	element_t *element = list->base;
+	size_t index = 0;
+
+	// The end of the list is after the tail, no walking is needed
+	if (!position) {
+		return add_element(list->size, list);
+	}
+	while (element->next != (void *) position) {
+		element = (element_t *) element->next;
+		index++;
+	}
+	return add_element(index, list);
+}
+
+aplib::singly_linked::position_t aplib::singly_linked::erase(position_t position,
+        internal_t *list)
+{
+	element_t *element = list->base;
+	element_t *next = (element_t *) position->next;
+	size_t index = 0;
+
+	while (element->next != (void *) position) {
+		element = (element_t *) element->next;
+		index++;
+	}
+	remove_element(index, list);
+	return next;
+}
+
+int aplib::singly_linked::splice(size_t index, internal_t *other,
+                                 internal_t *list)
+{
+	return splice_list(index, other, list);
+}
+
+aplib::singly_linked::internal_t *aplib::singly_linked::split(size_t index,
+        internal_t *list)
 {
-	internal_list = create_list(sizeof(type_t));
+	return split_list(index, list);
 }
 
-template<typename type_t>
-aplib::list<type_t>::~list()
+int aplib::singly_linked::sort(int (*compare)(const void *, const void *, void *),
+                               void *context, internal_t *list)
 {
-	delete_list(internal_list);
+	return sort_list_with_context(compare, context, list);
 }
 
-template<typename type_t>
-aplib::list<type_t> &aplib::list<type_t>::insert(size_t index)
+int aplib::singly_linked::unique(int (*compare)(const void *, const void *, void *),
+                                 void *context, internal_t *list)
 {
-	add_element(index, internal_list);
+	return unique_list_with_context(compare, context, list);
+}
+
+aplib::singly_linked::position_t aplib::singly_linked::find(size_t index,
+        internal_t *list)
+{
+	// The index of -1 would give the base
+	if (index >= list->size) {
+		return nullptr;
+	}
+	return get_element(index, list);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t>::list()
+	: list(alloc_t())
+{
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t>::list(const alloc_t &allocator)
+	: allocator(allocator)
+{
+	create_internal_list();
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t>::list(const list &other)
+	: allocator(std::allocator_traits<element_alloc_t>::
+	            select_on_container_copy_construction(other.allocator))
+{
+	create_internal_list();
+
+	// The destructor is not called if the constructor throws
+	try {
+		for (const type_t &value : other) {
+			emplace_back(value);
+		}
+	} catch (...) {
+		delete_internal_list();
+		throw;
+	}
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t>::list(list &&other) noexcept
+	: allocator(std::move(other.allocator)),
+	  internal_list(other.internal_list)
+{
+	other.internal_list = nullptr;
+
+	// The elements are allocated using the allocator of this list now
+	if (internal_list && internal_list->allocator.allocate) {
+		internal_list->allocator.context = (void *) &allocator;
+	}
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t>::~list()
+{
+	delete_internal_list();
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+void aplib::list<type_t, alloc_t, backend_t>::create_internal_list()
+{
+	list_allocator_t internal_allocator;
+	internal_allocator.allocate = allocate_element;
+	internal_allocator.deallocate = deallocate_element;
+	internal_allocator.release = nullptr;
+	internal_allocator.context = (void *) &allocator;
+
+	// The default allocator is the same as the malloc of the list
+	if (std::is_same<alloc_t, std::allocator<type_t>>::value) {
+		internal_list = backend_t::create(sizeof(type_t), nullptr);
+	} else {
+		internal_list = backend_t::create(sizeof(type_t),
+		                                  &internal_allocator);
+	}
+	if (!internal_list) {
+		throw std::bad_alloc();
+	}
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+void aplib::list<type_t, alloc_t, backend_t>::delete_internal_list()
+{
+	// A moved from list has no internal list
+	if (!internal_list) {
+		return;
+	}
+	clear();
+	backend_t::destroy(internal_list);
+	internal_list = nullptr;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::operator=(const
+        list &other)
+{
+	if (this == &other) {
+		return *this;
+	}
+	if (!internal_list) {
+		create_internal_list();
+	}
+
+	clear();
+	for (const type_t &value : other) {
+		emplace_back(value);
+	}
 	return *this;
 }
 
-template<typename type_t>
-aplib::list<type_t> &aplib::list<type_t>::insert(size_t index, type_t value)
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::operator=(
+        list &&other) noexcept(std::allocator_traits<alloc_t>::
+                               propagate_on_container_move_assignment::value)
 {
-	*(type_t *) add_element(index, internal_list)->data = value;
+	using traits = std::allocator_traits<element_alloc_t>;
+
+	if (this == &other) {
+		return *this;
+	}
+
+	// The elements can be taken if the allocator goes with them,
+	// otherwise they are moved one by one into this list's elements
+	if (traits::propagate_on_container_move_assignment::value
+	    || allocator == other.allocator) {
+		delete_internal_list();
+		if constexpr (traits::propagate_on_container_move_assignment::value) {
+			allocator = std::move(other.allocator);
+		}
+		internal_list = other.internal_list;
+		other.internal_list = nullptr;
+		if (internal_list && internal_list->allocator.allocate) {
+			internal_list->allocator.context = (void *) &allocator;
+		}
+		return *this;
+	}
+
+	if (!internal_list) {
+		create_internal_list();
+	}
+	clear();
+	for (type_t &value : other) {
+		emplace_back(std::move(value));
+	}
+	other.clear();
 	return *this;
 }
 
-template<typename type_t>
-aplib::list<type_t> &aplib::list<type_t>::erase(size_t index)
+template<typename type_t, typename alloc_t, typename backend_t>
+void aplib::list<type_t, alloc_t, backend_t>::swap(list &other) noexcept
+{
+	using std::swap;
+
+	if constexpr (std::allocator_traits<element_alloc_t>::
+	              propagate_on_container_swap::value) {
+		swap(allocator, other.allocator);
+	}
+	swap(internal_list, other.internal_list);
+
+	if (internal_list && internal_list->allocator.allocate) {
+		internal_list->allocator.context = (void *) &allocator;
+	}
+	if (other.internal_list && other.internal_list->allocator.allocate) {
+		other.internal_list->allocator.context = (void *) &other.allocator;
+	}
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+alloc_t aplib::list<type_t, alloc_t, backend_t>::get_allocator() const
 {
-	remove_element(index, internal_list);
+	return alloc_t(allocator);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+void *aplib::list<type_t, alloc_t, backend_t>::allocate_element(void *context,
+        size_t size)
+{
+	element_alloc_t &allocator = *(element_alloc_t *) context;
+	size_t count = (size + sizeof(std::max_align_t) - 1)
+	               / sizeof(std::max_align_t);
+
+	// The C list reports allocation failures by returning null
+	try {
+		return (void *) std::allocator_traits<element_alloc_t>::
+		       allocate(allocator, count);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+void aplib::list<type_t, alloc_t, backend_t>::deallocate_element(void *context,
+        void *pointer, size_t size)
+{
+	element_alloc_t &allocator = *(element_alloc_t *) context;
+	size_t count = (size + sizeof(std::max_align_t) - 1)
+	               / sizeof(std::max_align_t);
+
+	std::allocator_traits<element_alloc_t>::deallocate(allocator,
+	        (std::max_align_t *) pointer, count);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+template<typename... args_t>
+type_t &aplib::list<type_t, alloc_t, backend_t>::emplace(size_t index, args_t &&... args)
+{
+	void *data = nullptr;
+
+	if (index > size()) {
+		throw std::out_of_range("aplib::list::emplace");
+	}
+	// A moved from list gets a new internal list when it is used again
+	if (!internal_list) {
+		create_internal_list();
+	}
+	data = backend_t::add(index, internal_list);
+	if (!data) {
+		throw std::bad_alloc();
+	}
+
+	// Remove the element again if the value could not be constructed
+	try {
+		return *new (data) type_t(std::forward<args_t>(args)...);
+	} catch (...) {
+		backend_t::remove(index, internal_list);
+		throw;
+	}
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+template<typename... args_t>
+type_t &aplib::list<type_t, alloc_t, backend_t>::emplace_front(args_t &&... args)
+{
+	return emplace(0, std::forward<args_t>(args)...);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+template<typename... args_t>
+type_t &aplib::list<type_t, alloc_t, backend_t>::emplace_back(args_t &&... args)
+{
+	return emplace(size(), std::forward<args_t>(args)...);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::insert(size_t index)
+{
+	emplace(index);
 	return *this;
 }
 
-template<typename type_t>
-size_t aplib::list<type_t>::size()
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::insert(size_t index,
+        const type_t &value)
 {
-	return get_list_size(internal_list);
+	emplace(index, value);
+	return *this;
 }
 
-template<typename type_t>
-type_t &aplib::list<type_t>::at(size_t index)
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::insert(size_t index,
+        type_t &&value)
 {
-	return *(type_t *) get_element(index, internal_list)->data;
+	emplace(index, std::move(value));
+	return *this;
 }
 
-template<typename type_t>
-aplib::list<type_t> &aplib::list<type_t>::clear()
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::erase(size_t index)
 {
-	clear_list(internal_list);
+	type_t *value = nullptr;
+
+	if (index >= size()) {
+		return *this;
+	}
+	value = (type_t *) backend_t::get(index, internal_list);
+	if (!value) {
+		return *this;
+	}
+	value->~type_t();
+	backend_t::remove(index, internal_list);
 	return *this;
 }
 
-template<typename type_t>
-aplib::list<type_t> &aplib::list<type_t>::push_back()
+template<typename type_t, typename alloc_t, typename backend_t>
+template<typename input_t, typename>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::insert(size_t index,
+        input_t first, input_t last)
 {
-	insert(size());
+	size_t added = 0;
+
+	if (index > size()) {
+		throw std::out_of_range("aplib::list::insert");
+	}
+
+	// Adding after the last added element does not walk again,
+	// the values added so far are removed if one can not be added
+	try {
+		for (; first != last; ++first, ++added) {
+			emplace(index + added, *first);
+		}
+	} catch (...) {
+		erase(index, added);
+		throw;
+	}
 	return *this;
 }
 
-template<typename type_t>
-aplib::list<type_t> &aplib::list<type_t>::push_back(type_t value)
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::erase(size_t index,
+        size_t count)
 {
-	insert(size(), value);
+	size_t list_size = size();
+
+	if (index >= list_size) {
+		return *this;
+	}
+	if (count > list_size - index) {
+		count = list_size - index;
+	}
+
+	// The values are destroyed walking from the index once, and the
+	// backend removes all the elements at once
+	if (!std::is_trivially_destructible<type_t>::value) {
+		position_t position = backend_t::find(index, internal_list);
+		for (size_t i = 0; i < count; i++) {
+			((type_t *) backend_t::data(position))->~type_t();
+			position = backend_t::next(position);
+		}
+	}
+	backend_t::remove(index, count, internal_list);
 	return *this;
 }
 
-template<typename type_t>
-aplib::list<type_t> &aplib::list<type_t>::pop_back()
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::splice(size_t index,
+        list &other)
 {
-	erase(size());
+	if (index > size()) {
+		throw std::out_of_range("aplib::list::splice");
+	}
+	if (this == &other || !other.internal_list) {
+		return *this;
+	}
+	if (!internal_list) {
+		create_internal_list();
+	}
+
+	if (allocator != other.allocator) {
+		insert(index, std::make_move_iterator(other.begin()),
+		       std::make_move_iterator(other.end()));
+		other.clear();
+		return *this;
+	}
+	if (backend_t::splice(index, other.internal_list, internal_list)) {
+		throw std::bad_alloc();
+	}
 	return *this;
 }
 
-template<typename type_t>
-aplib::list<type_t>::iterator::iterator(list_t *internal_list)
-	: list(internal_list)
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> aplib::list<type_t, alloc_t, backend_t>::split(size_t index)
+{
+	list result(get_allocator());
+	internal_t *elements = nullptr;
+
+	if (index > size()) {
+		throw std::out_of_range("aplib::list::split");
+	}
+	if (!internal_list) {
+		return result;
+	}
+	elements = backend_t::split(index, internal_list);
+	if (!elements) {
+		throw std::bad_alloc();
+	}
+
+	// The elements are allocated using the allocator of the new list now
+	backend_t::destroy(result.internal_list);
+	result.internal_list = elements;
+	if (elements->allocator.allocate) {
+		elements->allocator.context = (void *) &result.allocator;
+	}
+	return result;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::sort()
 {
-	index = 0;
+	return sort(std::less<type_t>());
 }
 
-template<typename type_t>
-typename aplib::list<type_t>::iterator &
-aplib::list<type_t>::iterator::operator++()
+template<typename type_t, typename alloc_t, typename backend_t>
+template<typename compare_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::sort(compare_t compare)
 {
-	index++;
+	sort_context<compare_t> sorting {&compare, nullptr};
+
+	if (size() < 2) {
+		return *this;
+	}
+	if (backend_t::sort(compare_values<compare_t>, (void *) &sorting,
+	                    internal_list)) {
+		throw std::bad_alloc();
+	}
+	if (sorting.error) {
+		std::rethrow_exception(sorting.error);
+	}
 	return *this;
 }
 
-template<typename type_t>
-bool aplib::list<type_t>::iterator::operator!=(const
-        aplib::list<type_t>::iterator& compare)
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::merge(list &other)
 {
-	return index != compare.index;
+	return merge(other, std::less<type_t>());
 }
 
-template<typename type_t>
-type_t &aplib::list<type_t>::iterator::operator*()
+template<typename type_t, typename alloc_t, typename backend_t>
+template<typename compare_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::merge(list &other,
+        compare_t compare)
 {
-	return *(type_t *) get_element(index, list)->data;
+	if (this == &other) {
+		return *this;
+	}
+
+	// Sorting finds the two runs and merges them in one pass
+	splice(size(), other);
+	return sort(compare);
 }
 
-template<typename type_t>
-typename aplib::list<type_t>::iterator aplib::list<type_t>::begin()
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::unique()
 {
-	iterator beginning(internal_list);
-	beginning.index = 0;
-	return beginning;
+	return unique(std::equal_to<type_t>());
 }
 
-template<typename type_t>
-typename aplib::list<type_t>::iterator aplib::list<type_t>::end()
+template<typename type_t, typename alloc_t, typename backend_t>
+template<typename predicate_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::unique(predicate_t predicate)
 {
-	iterator ending(internal_list);
-	ending.index = size();
-	return ending;
+	sort_context<predicate_t> uniting {&predicate, nullptr};
+
+	if (size() < 2) {
+		return *this;
+	}
+	if (backend_t::unique(unique_values<predicate_t>, (void *) &uniting,
+	                      internal_list)) {
+		throw std::bad_alloc();
+	}
+	if (uniting.error) {
+		std::rethrow_exception(uniting.error);
+	}
+	return *this;
 }
 
-template<typename type_t>
-type_t &aplib::list<type_t>::operator[](size_t index)
+template<typename type_t, typename alloc_t, typename backend_t>
+template<typename compare_t>
+int aplib::list<type_t, alloc_t, backend_t>::unique_values(const void *first,
+        const void *second, void *context)
+{
+	sort_context<compare_t> *uniting = (sort_context<compare_t> *) context;
+
+	// The second value is destroyed when the backend is told to remove it,
+	// all the values are kept after the predicate throws
+	if (uniting->error) {
+		return 1;
+	}
+	try {
+		if (!(*uniting->compare)(*(const type_t *) first,
+		                         *(const type_t *) second)) {
+			return 1;
+		}
+	} catch (...) {
+		uniting->error = std::current_exception();
+		return 1;
+	}
+	((type_t *) second)->~type_t();
+	return 0;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+template<typename compare_t>
+int aplib::list<type_t, alloc_t, backend_t>::compare_values(const void *first,
+        const void *second, void *context)
+{
+	sort_context<compare_t> *sorting = (sort_context<compare_t> *) context;
+
+	// The backend only asks if the first is greater than the second
+	if (sorting->error) {
+		return 0;
+	}
+	try {
+		return (*sorting->compare)(*(const type_t *) second,
+		                           *(const type_t *) first) ? 1 : 0;
+	} catch (...) {
+		sorting->error = std::current_exception();
+		return 0;
+	}
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+size_t aplib::list<type_t, alloc_t, backend_t>::size() const
+{
+	return backend_t::size(internal_list);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+type_t &aplib::list<type_t, alloc_t, backend_t>::at(size_t index)
+{
+	return *(type_t *) backend_t::get(index, internal_list);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+type_t &aplib::list<type_t, alloc_t, backend_t>::front()
+{
+	return *begin();
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+type_t &aplib::list<type_t, alloc_t, backend_t>::back()
+{
+	return at(size() - 1);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::clear()
+{
+	if (!internal_list) {
+		return *this;
+	}
+	if (!std::is_trivially_destructible<type_t>::value) {
+		for (type_t &value : *this) {
+			value.~type_t();
+		}
+	}
+	backend_t::clear(internal_list);
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::push_back()
+{
+	emplace_back();
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::push_back(const
+        type_t &value)
+{
+	emplace_back(value);
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::push_back(type_t
+        &&value)
+{
+	emplace_back(std::move(value));
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::pop_back()
+{
+	if (size() > 0) {
+		erase(size() - 1);
+	}
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::push_front()
+{
+	emplace_front();
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::push_front(const
+        type_t &value)
+{
+	emplace_front(value);
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::push_front(type_t
+        &&value)
+{
+	emplace_front(std::move(value));
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t> &aplib::list<type_t, alloc_t, backend_t>::pop_front()
+{
+	if (size() > 0) {
+		erase(0);
+	}
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t>::iterator::iterator(position_t position)
+	: position(position)
+{
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t>::iterator::iterator()
+	: position()
+{
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::iterator &
+aplib::list<type_t, alloc_t, backend_t>::iterator::operator++()
+{
+	position = backend_t::next(position);
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::iterator
+aplib::list<type_t, alloc_t, backend_t>::iterator::operator++(int)
+{
+	iterator previous = *this;
+	++*this;
+	return previous;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::iterator &
+aplib::list<type_t, alloc_t, backend_t>::iterator::operator--()
+{
+	position = backend_t::prev(position);
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::iterator
+aplib::list<type_t, alloc_t, backend_t>::iterator::operator--(int)
+{
+	iterator next = *this;
+	--*this;
+	return next;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+bool aplib::list<type_t, alloc_t, backend_t>::iterator::operator==(const
+        aplib::list<type_t, alloc_t, backend_t>::iterator& compare) const
+{
+	return position == compare.position;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+bool aplib::list<type_t, alloc_t, backend_t>::iterator::operator!=(const
+        aplib::list<type_t, alloc_t, backend_t>::iterator& compare) const
+{
+	return position != compare.position;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+type_t &aplib::list<type_t, alloc_t, backend_t>::iterator::operator*() const
+{
+	return *(type_t *) backend_t::data(position);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+type_t *aplib::list<type_t, alloc_t, backend_t>::iterator::operator->() const
+{
+	return (type_t *) backend_t::data(position);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t>::const_iterator::const_iterator(position_t position)
+	: position(position)
+{
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t>::const_iterator::const_iterator(const
+        aplib::list<type_t, alloc_t, backend_t>::iterator &other)
+	: position(other.position)
+{
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+aplib::list<type_t, alloc_t, backend_t>::const_iterator::const_iterator()
+	: position()
+{
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::const_iterator &
+aplib::list<type_t, alloc_t, backend_t>::const_iterator::operator++()
+{
+	position = backend_t::next(position);
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::const_iterator
+aplib::list<type_t, alloc_t, backend_t>::const_iterator::operator++(int)
+{
+	const_iterator previous = *this;
+	++*this;
+	return previous;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::const_iterator &
+aplib::list<type_t, alloc_t, backend_t>::const_iterator::operator--()
+{
+	position = backend_t::prev(position);
+	return *this;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::const_iterator
+aplib::list<type_t, alloc_t, backend_t>::const_iterator::operator--(int)
+{
+	const_iterator next = *this;
+	--*this;
+	return next;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+bool aplib::list<type_t, alloc_t, backend_t>::const_iterator::operator==(const
+        aplib::list<type_t, alloc_t, backend_t>::const_iterator& compare) const
+{
+	return position == compare.position;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+bool aplib::list<type_t, alloc_t, backend_t>::const_iterator::operator!=(const
+        aplib::list<type_t, alloc_t, backend_t>::const_iterator& compare) const
+{
+	return position != compare.position;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+const type_t &aplib::list<type_t, alloc_t, backend_t>::const_iterator::operator*() const
+{
+	return *(const type_t *) backend_t::data(position);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+const type_t *aplib::list<type_t, alloc_t, backend_t>::const_iterator::operator->() const
+{
+	return (const type_t *) backend_t::data(position);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::iterator aplib::list<type_t, alloc_t, backend_t>::begin()
+{
+	if (!internal_list) {
+		return iterator();
+	}
+	return iterator(backend_t::begin(internal_list));
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::iterator aplib::list<type_t, alloc_t, backend_t>::end()
+{
+	if (!internal_list) {
+		return iterator();
+	}
+	return iterator(backend_t::end(internal_list));
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::const_iterator aplib::list<type_t, alloc_t, backend_t>::begin() const
+{
+	return cbegin();
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::const_iterator aplib::list<type_t, alloc_t, backend_t>::end() const
+{
+	return cend();
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::const_iterator aplib::list<type_t, alloc_t, backend_t>::cbegin() const
+{
+	if (!internal_list) {
+		return const_iterator();
+	}
+	return const_iterator(backend_t::begin(internal_list));
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::const_iterator aplib::list<type_t, alloc_t, backend_t>::cend() const
+{
+	if (!internal_list) {
+		return const_iterator();
+	}
+	return const_iterator(backend_t::end(internal_list));
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::iterator aplib::list<type_t, alloc_t, backend_t>::nth(size_t index)
+{
+	if (!internal_list) {
+		return iterator();
+	}
+	return iterator(backend_t::find(index, internal_list));
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::const_iterator aplib::list<type_t, alloc_t, backend_t>::nth(size_t index) const
+{
+	if (!internal_list) {
+		return const_iterator();
+	}
+	return const_iterator(backend_t::find(index, internal_list));
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+template<typename... args_t>
+typename aplib::list<type_t, alloc_t, backend_t>::iterator
+aplib::list<type_t, alloc_t, backend_t>::emplace(const_iterator position,
+        args_t &&... args)
+{
+	position_t added = position_t();
+
+	// The only position of a moved from list is its end
+	if (!internal_list) {
+		create_internal_list();
+		position = cend();
+	}
+	added = backend_t::insert(position.position, internal_list);
+
+	// Backends give the end if the element could not be added
+	if (added == backend_t::end(internal_list)) {
+		throw std::bad_alloc();
+	}
+
+	// Remove the element again if the value could not be constructed
+	try {
+		new (backend_t::data(added)) type_t(std::forward<args_t>(args)...);
+	} catch (...) {
+		backend_t::erase(added, internal_list);
+		throw;
+	}
+	return iterator(added);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::iterator
+aplib::list<type_t, alloc_t, backend_t>::insert(const_iterator position,
+        const type_t &value)
+{
+	return emplace(position, value);
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::iterator
+aplib::list<type_t, alloc_t, backend_t>::insert(const_iterator position,
+        type_t &&value)
+{
+	return emplace(position, std::move(value));
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::iterator
+aplib::list<type_t, alloc_t, backend_t>::erase(const_iterator position)
+{
+	((type_t *) backend_t::data(position.position))->~type_t();
+	return iterator(backend_t::erase(position.position, internal_list));
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+type_t &aplib::list<type_t, alloc_t, backend_t>::operator[](size_t index)
 {
 	return at(index);
 }
 
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::list<type_t, alloc_t, backend_t>::native_handle_type
+aplib::list<type_t, alloc_t, backend_t>::native_handle() const
+{
+	return internal_list;
+}
+
 // LIST_IMPL
 #endif
 
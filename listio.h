@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Saving and loading for the Minimal C Linked List
+ *   Usage and other information is provided in the README.md file from the
+ *   repository. Please refer to that to know how to use this library.
+ */
+
+#ifndef LISTIO_H
+#define LISTIO_H "listio.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* The header and the checksum are used on any system, the C++ wrapper
+ * saves and loads lists with them through streams */
+#if defined(__unix__) || defined(__APPLE__)
+#define LISTIO_POSIX 1
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include "list.h"
+
+/* Implement the list code by defining
+ * LIST_IMPL before including this library */
+
+/* Saving and loading files is made for POSIX systems. The data of the
+ * elements is written straight from the elements and read straight into
+ * them, many elements at a time using writev and readv, nothing is copied
+ * in between. The file is read on machines with the same byte order only */
+
+#define LISTIO_MAGIC "APLISTS"
+#define LISTIO_VERSION 1
+
+/* A checksum of the data is written after it */
+#define LISTIO_CHECKSUM 1
+
+/* The number of elements written or read in one call */
+#ifndef LISTIO_BATCH
+#define LISTIO_BATCH 1024
+#endif
+
+/* The data of the elements follows the header, size times typesize bytes */
+struct listio_header_t {
+	char magic[8];
+	uint32_t version;
+	uint32_t flags;
+	uint64_t size;
+	uint64_t typesize;
+};
+
+/* These functions are not supposed to be used externally */
+uint64_t checksum_list_data(uint64_t checksum, const void *data, size_t length);
+
+#ifdef LISTIO_POSIX
+/* Writes the list to a file descriptor, the flags are LISTIO_CHECKSUM or
+ * 0. Flush a FILE before giving its fileno to write after what is in it */
+int write_list(int fd, int flags, struct list_t *list);
+/* Reads a list written by write_list into a new list, NULL is returned if
+ * the file is not a list of this version and type or the checksum fails */
+struct list_t *read_list(int fd, size_t typesize);
+struct list_t *read_list_with_allocator(int fd, size_t typesize,
+                                        const struct list_allocator_t *allocator);
+
+/* These functions are not supposed to be used externally */
+int write_list_vectors(int fd, struct iovec *vectors, int count);
+int read_list_vectors(int fd, struct iovec *vectors, int count);
+#endif
+
+#ifdef LIST_IMPL
+
+uint64_t checksum_list_data(uint64_t checksum, const void *data, size_t length)
+{
+	const unsigned char *bytes = (const unsigned char *) data;
+	size_t i = 0;
+
+	/* FNV-1a, starting from its offset basis */
+	if (!data) {
+		return 14695981039346656037ull;
+	}
+	for (i = 0; i < length; i++) {
+		checksum = (checksum ^ bytes[i]) * 1099511628211ull;
+	}
+	return checksum;
+}
+
+#ifdef LISTIO_POSIX
+int write_list(int fd, int flags, struct list_t *list)
+{
+	struct iovec vectors[LISTIO_BATCH];
+	struct listio_header_t header;
+	struct element_t *element = NULL;
+	uint64_t checksum = 0;
+	int count = 0;
+
+	if (!list) {
+		return 1;
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, LISTIO_MAGIC, sizeof(header.magic));
+	header.version = LISTIO_VERSION;
+	header.flags = (uint32_t) flags & LISTIO_CHECKSUM;
+	header.size = list->size;
+	header.typesize = list->typesize;
+	checksum = checksum_list_data(0, NULL, 0);
+
+	/* The header goes in the first batch */
+	vectors[0].iov_base = (void *) &header;
+	vectors[0].iov_len = sizeof(header);
+	count = 1;
+
+	for (element = (struct element_t *) list->base->next; element;
+	     element = (struct element_t *) element->next) {
+		vectors[count].iov_base = element->data;
+		vectors[count].iov_len = list->typesize;
+		count++;
+		if (header.flags & LISTIO_CHECKSUM) {
+			checksum = checksum_list_data(checksum, element->data, list->typesize);
+		}
+		if (count == LISTIO_BATCH) {
+			if (write_list_vectors(fd, vectors, count)) {
+				return 2;
+			}
+			count = 0;
+		}
+	}
+
+	if (header.flags & LISTIO_CHECKSUM) {
+		vectors[count].iov_base = (void *) &checksum;
+		vectors[count].iov_len = sizeof(checksum);
+		count++;
+	}
+	if (count && write_list_vectors(fd, vectors, count)) {
+		return 2;
+	}
+	return 0;
+}
+
+struct list_t *read_list(int fd, size_t typesize)
+{
+	return read_list_with_allocator(fd, typesize, NULL);
+}
+
+struct list_t *read_list_with_allocator(int fd, size_t typesize,
+                                        const struct list_allocator_t *allocator)
+{
+	struct iovec vectors[LISTIO_BATCH];
+	struct listio_header_t header;
+	struct list_t *list = NULL;
+	struct element_t *first = NULL;
+	struct element_t *element = NULL;
+	uint64_t checksum = 0;
+	uint64_t expected = 0;
+	size_t count = 0;
+	size_t i = 0;
+
+	vectors[0].iov_base = (void *) &header;
+	vectors[0].iov_len = sizeof(header);
+	if (read_list_vectors(fd, vectors, 1)) {
+		return NULL;
+	}
+	if (memcmp(header.magic, LISTIO_MAGIC, sizeof(header.magic))
+	    || header.version != LISTIO_VERSION || header.typesize != typesize) {
+		return NULL;
+	}
+
+	list = create_list_with_allocator(typesize, allocator);
+	if (!list) {
+		return NULL;
+	}
+	checksum = checksum_list_data(0, NULL, 0);
+
+	/* Every batch of elements is added at once and read into directly */
+	while (list->size < header.size) {
+		count = header.size - list->size;
+		if (count > LISTIO_BATCH) {
+			count = LISTIO_BATCH;
+		}
+		first = add_elements(list->size, NULL, count, list);
+		if (!first) {
+			delete_list(list);
+			return NULL;
+		}
+		element = first;
+		for (i = 0; i < count; i++) {
+			vectors[i].iov_base = element->data;
+			vectors[i].iov_len = typesize;
+			element = (struct element_t *) element->next;
+		}
+		if (read_list_vectors(fd, vectors, (int) count)) {
+			delete_list(list);
+			return NULL;
+		}
+		element = first;
+		for (i = 0; i < count && (header.flags & LISTIO_CHECKSUM); i++) {
+			checksum = checksum_list_data(checksum, element->data, typesize);
+			element = (struct element_t *) element->next;
+		}
+	}
+
+	if (header.flags & LISTIO_CHECKSUM) {
+		vectors[0].iov_base = (void *) &expected;
+		vectors[0].iov_len = sizeof(expected);
+		if (read_list_vectors(fd, vectors, 1) || checksum != expected) {
+			delete_list(list);
+			return NULL;
+		}
+	}
+	return list;
+}
+
+int write_list_vectors(int fd, struct iovec *vectors, int count)
+{
+	ssize_t done = 0;
+
+	/* The vectors are moved past what is written until all of it is */
+	while (count > 0) {
+		done = writev(fd, vectors, count);
+		if (done < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return 2;
+		}
+		while (count > 0 && (size_t) done >= vectors->iov_len) {
+			done -= (ssize_t) vectors->iov_len;
+			vectors++;
+			count--;
+		}
+		if (count > 0) {
+			vectors->iov_base = (char *) vectors->iov_base + done;
+			vectors->iov_len -= (size_t) done;
+		}
+	}
+	return 0;
+}
+
+int read_list_vectors(int fd, struct iovec *vectors, int count)
+{
+	ssize_t done = 0;
+
+	while (count > 0) {
+		done = readv(fd, vectors, count);
+		if (done < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return 2;
+		}
+		if (done == 0) {
+			/* The file ended before the list */
+			return 3;
+		}
+		while (count > 0 && (size_t) done >= vectors->iov_len) {
+			done -= (ssize_t) vectors->iov_len;
+			vectors++;
+			count--;
+		}
+		if (count > 0) {
+			vectors->iov_base = (char *) vectors->iov_base + done;
+			vectors->iov_len -= (size_t) done;
+		}
+	}
+	return 0;
+}
+
+/* LISTIO_POSIX */
+#endif
+
+/* LIST_IMPL */
+#endif
+
+/* LISTIO_H */
+#endif
@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Saving and loading for the C++ Wrapper of the Minimal C Linked List
+//   Usage and other information is provided in the README.md file from the
+//   repository. Please refer to that to know how to use this library.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LISTIO_HPP
+#define LISTIO_HPP "listio.hpp"
+
+// This header is just a wrapper for the saving and loading of the list
+#include "listio.h"
+#include "list.hpp"
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace aplib
+{
+// Types that are not trivially copyable are written and read one by one
+// using a specialization of the serializer, which has the functions
+//   static void write(std::ostream &stream, const type_t &value);
+//   static type_t read(std::istream &stream);
+template<typename type_t>
+struct serializer;
+
+// Lists of any backend are written in the format of write_list, their
+// values are written in batches if they are trivially copyable. The
+// checksum is only written for them, a serializer has its own format
+template<typename type_t, typename alloc_t, typename backend_t>
+std::ostream &write_list(std::ostream &stream,
+                         const list<type_t, alloc_t, backend_t> &values,
+                         int flags = 0);
+// The list is cleared and the values are added to it, the failbit is set
+// if the stream does not hold a list of this version and type. The list
+// is left empty if the read fails or the checksum does not match
+template<typename type_t, typename alloc_t, typename backend_t>
+std::istream &read_list(std::istream &stream,
+                        list<type_t, alloc_t, backend_t> &values);
+}
+
+#ifdef LIST_IMPL
+
+template<typename type_t, typename alloc_t, typename backend_t>
+std::ostream &aplib::write_list(std::ostream &stream,
+                                const list<type_t, alloc_t, backend_t> &values,
+                                int flags)
+{
+	constexpr bool trivial = std::is_trivially_copyable<type_t>::value;
+	listio_header_t header;
+	std::vector<char> buffer;
+	uint64_t checksum = checksum_list_data(0, nullptr, 0);
+
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, LISTIO_MAGIC, sizeof(header.magic));
+	header.version = LISTIO_VERSION;
+	header.flags = trivial ? (uint32_t) flags & LISTIO_CHECKSUM : 0;
+	header.size = values.size();
+	header.typesize = trivial ? sizeof(type_t) : 0;
+	stream.write((const char *) &header, sizeof(header));
+
+	if constexpr (trivial) {
+		buffer.reserve(LISTIO_BATCH * sizeof(type_t));
+		for (const type_t &value : values) {
+			buffer.insert(buffer.end(), (const char *) &value,
+			              (const char *) &value + sizeof(type_t));
+			if (buffer.size() == LISTIO_BATCH * sizeof(type_t)) {
+				checksum = checksum_list_data(checksum, buffer.data(), buffer.size());
+				stream.write(buffer.data(), buffer.size());
+				buffer.clear();
+			}
+		}
+		checksum = checksum_list_data(checksum, buffer.data(), buffer.size());
+		stream.write(buffer.data(), buffer.size());
+		if (header.flags & LISTIO_CHECKSUM) {
+			stream.write((const char *) &checksum, sizeof(checksum));
+		}
+	} else {
+		for (const type_t &value : values) {
+			serializer<type_t>::write(stream, value);
+		}
+	}
+	return stream;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+std::istream &aplib::read_list(std::istream &stream,
+                               list<type_t, alloc_t, backend_t> &values)
+{
+	constexpr bool trivial = std::is_trivially_copyable<type_t>::value;
+	listio_header_t header;
+	std::vector<char> buffer;
+	uint64_t checksum = checksum_list_data(0, nullptr, 0);
+	uint64_t expected = 0;
+	uint64_t remaining = 0;
+	size_t count = 0;
+	// The values are loaded into another list, so that a failed read
+	// leaves the list empty instead of partly loaded
+	list<type_t, alloc_t, backend_t> loaded(values.get_allocator());
+
+	values.clear();
+	if (!stream.read((char *) &header, sizeof(header))) {
+		return stream;
+	}
+	if (std::memcmp(header.magic, LISTIO_MAGIC, sizeof(header.magic))
+	    || header.version != LISTIO_VERSION
+	    || header.typesize != (trivial ? sizeof(type_t) : 0)) {
+		stream.setstate(std::ios_base::failbit);
+		return stream;
+	}
+
+	if constexpr (trivial) {
+		// The values are copied out of the buffer into storage aligned
+		// for them, they may not have a default constructor
+		alignas(type_t) unsigned char storage[sizeof(type_t)];
+
+		remaining = header.size;
+		while (remaining > 0) {
+			count = remaining < LISTIO_BATCH ? (size_t) remaining : LISTIO_BATCH;
+			buffer.resize(count * sizeof(type_t));
+			if (!stream.read(buffer.data(), buffer.size())) {
+				return stream;
+			}
+			checksum = checksum_list_data(checksum, buffer.data(), buffer.size());
+			for (size_t i = 0; i < count; i++) {
+				std::memcpy(storage, buffer.data() + i * sizeof(type_t), sizeof(type_t));
+				loaded.push_back(*(const type_t *) storage);
+			}
+			remaining -= count;
+		}
+		if (header.flags & LISTIO_CHECKSUM) {
+			if (!stream.read((char *) &expected, sizeof(expected))) {
+				return stream;
+			}
+			if (checksum != expected) {
+				stream.setstate(std::ios_base::failbit);
+				return stream;
+			}
+		}
+	} else {
+		for (remaining = header.size; remaining > 0; remaining--) {
+			type_t value = serializer<type_t>::read(stream);
+			if (!stream) {
+				return stream;
+			}
+			loaded.push_back(std::move(value));
+		}
+	}
+	values.swap(loaded);
+	return stream;
+}
+
+// LIST_IMPL
+#endif
+
+// LISTIO_HPP
+#endif
@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * A Minimal C Lock-Free Queue
+ *   Usage and other information is provided in the README.md file from the
+ *   repository. Please refer to that to know how to use this library.
+ */
+
+#ifndef LQUEUE_H
+#define LQUEUE_H "lqueue.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* The queue aligns its data like the list */
+#include "list.h"
+
+/* Implement the list code by defining
+ * LIST_IMPL before including this library */
+
+/* The queue is made for GCC and Clang, it uses their __atomic built-ins
+ * like the lock-free list. It is bounded, every node is allocated when the
+ * queue is created and free nodes are kept in a list of their own, so a
+ * node is never freed while another thread may be looking at it */
+
+/* Any number of threads can enqueue and dequeue (Michael and Scott) */
+#define LQUEUE_MPMC 0
+/* Any number of threads can enqueue, and only one thread dequeues. Linking
+ * a node in is wait-free (Vyukov), taking a free node is lock-free */
+#define LQUEUE_MPSC 1
+
+/* Links hold the index of a node in the lower half, and a tag in the upper
+ * half that changes on every update. A node reused between reading a link
+ * and updating it does not give the same link (the ABA problem) */
+#define LQUEUE_NULL 0xffffffffu
+#define LQUEUE_INDEX(link) ((uint32_t) (link))
+#define LQUEUE_TAG(link) ((uint32_t) ((link) >> 32))
+#define LQUEUE_LINK(index, tag) (((uint64_t) (tag) << 32) | (uint32_t) (index))
+
+/* Nodes are like the elements of the list, with links instead of pointers */
+struct lqnode_t {
+	void *data;
+	uint64_t next;
+	/* Links the free nodes */
+	uint64_t free;
+};
+
+struct lqueue_t {
+	/* The first node is a dummy, the data is in the nodes after it */
+	uint64_t head;
+	/* Keeps the consumers and the producers off the same cache line */
+	char head_padding[64];
+	uint64_t tail;
+	char tail_padding[64];
+	uint64_t free;
+	char free_padding[64];
+	/* The size changes while the queue is used, it is only a hint */
+	size_t size;
+	size_t typesize;
+	size_t capacity;
+	int mode;
+	/* One more node than the capacity for the dummy */
+	struct lqnode_t *nodes;
+};
+
+
+/* Returns NULL if the capacity does not fit in the links */
+struct lqueue_t *create_lqueue(size_t typesize, size_t capacity, int mode);
+size_t get_lqueue_size(struct lqueue_t *queue);
+
+/* The data is copied into the queue, 2 is returned if the queue is full */
+int enqueue_lqueue(struct lqueue_t *queue, const void *data);
+/* The data is copied out of the queue, 2 is returned if the queue is empty.
+ * An MPSC queue can look empty while a producer is linking a node in */
+int dequeue_lqueue(struct lqueue_t *queue, void *data);
+
+/* The data is an array of count elements, the batch is linked in at once.
+ * Returns the number of elements enqueued or dequeued */
+size_t enqueue_lqueue_batch(struct lqueue_t *queue, const void *data, size_t count);
+size_t dequeue_lqueue_batch(struct lqueue_t *queue, void *data, size_t count);
+
+/* Deleting a queue is not thread safe, every thread must be done with it */
+int delete_lqueue(struct lqueue_t *queue);
+
+/* These functions are not supposed to be used externally */
+uint32_t take_lqnode(struct lqueue_t *queue);
+void give_lqnode(uint32_t index, struct lqueue_t *queue);
+void link_lqnodes(uint32_t first, uint32_t last, struct lqueue_t *queue);
+
+#ifdef LIST_IMPL
+
+struct lqueue_t *create_lqueue(size_t typesize, size_t capacity, int mode)
+{
+	struct lqueue_t *queue = NULL;
+	size_t offset = 0;
+	size_t stride = typesize ? typesize : 1;
+
+	if (capacity >= LQUEUE_NULL || (mode != LQUEUE_MPMC && mode != LQUEUE_MPSC)) {
+		return NULL;
+	}
+
+	queue = (struct lqueue_t *) malloc(sizeof(struct lqueue_t));
+	if (!queue) {
+		return NULL;
+	}
+
+	/* The nodes and their data are allocated at once */
+	offset = align_data_offset((capacity + 1) * sizeof(struct lqnode_t), typesize);
+	queue->nodes = (struct lqnode_t *) malloc(offset + (capacity + 1) * stride);
+	if (!queue->nodes) {
+		free(queue);
+		return NULL;
+	}
+
+	for (size_t i = 0; i <= capacity; i++) {
+		queue->nodes[i].data = (char *) queue->nodes + offset + i * stride;
+		queue->nodes[i].next = LQUEUE_LINK(LQUEUE_NULL, 0);
+		queue->nodes[i].free = LQUEUE_LINK(i + 1 <= capacity ? i + 1 : LQUEUE_NULL, 0);
+	}
+
+	/* The node 0 is the dummy, the others are free */
+	queue->head = LQUEUE_LINK(0, 0);
+	queue->tail = LQUEUE_LINK(0, 0);
+	queue->free = LQUEUE_LINK(capacity ? 1 : LQUEUE_NULL, 0);
+	queue->size = 0;
+	queue->typesize = typesize;
+	queue->capacity = capacity;
+	queue->mode = mode;
+	return queue;
+}
+
+size_t get_lqueue_size(struct lqueue_t *queue)
+{
+	if (!queue) {
+		return 0;
+	}
+	return __atomic_load_n(&queue->size, __ATOMIC_RELAXED);
+}
+
+int enqueue_lqueue(struct lqueue_t *queue, const void *data)
+{
+	if (!queue) {
+		return 1;
+	}
+	return enqueue_lqueue_batch(queue, data, 1) ? 0 : 2;
+}
+
+int dequeue_lqueue(struct lqueue_t *queue, void *data)
+{
+	if (!queue) {
+		return 1;
+	}
+	return dequeue_lqueue_batch(queue, data, 1) ? 0 : 2;
+}
+
+size_t enqueue_lqueue_batch(struct lqueue_t *queue, const void *data, size_t count)
+{
+	uint32_t first = LQUEUE_NULL;
+	uint32_t last = LQUEUE_NULL;
+	uint32_t index = 0;
+	uint64_t next = 0;
+	size_t taken = 0;
+
+	if (!queue) {
+		return 0;
+	}
+
+	/* The nodes of the batch are linked together before linking them in */
+	for (; taken < count; taken++) {
+		index = take_lqnode(queue);
+		if (index == LQUEUE_NULL) {
+			break;
+		}
+		if (data) {
+			memcpy(queue->nodes[index].data,
+			       (const char *) data + taken * queue->typesize, queue->typesize);
+		}
+
+		/* The tag of the next keeps counting across the uses of the node */
+		next = __atomic_load_n(&queue->nodes[index].next, __ATOMIC_RELAXED);
+		__atomic_store_n(&queue->nodes[index].next,
+		                 LQUEUE_LINK(LQUEUE_NULL, LQUEUE_TAG(next) + 1),
+		                 __ATOMIC_RELAXED);
+		if (last != LQUEUE_NULL) {
+			next = __atomic_load_n(&queue->nodes[last].next, __ATOMIC_RELAXED);
+			__atomic_store_n(&queue->nodes[last].next,
+			                 LQUEUE_LINK(index, LQUEUE_TAG(next) + 1), __ATOMIC_RELAXED);
+		} else {
+			first = index;
+		}
+		last = index;
+	}
+
+	if (taken) {
+		__atomic_fetch_add(&queue->size, taken, __ATOMIC_RELAXED);
+		link_lqnodes(first, last, queue);
+	}
+	return taken;
+}
+
+size_t dequeue_lqueue_batch(struct lqueue_t *queue, void *data, size_t count)
+{
+	uint64_t head = 0;
+	uint64_t tail = 0;
+	uint64_t next = 0;
+	size_t taken = 0;
+	char *copy = (char *) data;
+
+	if (!queue) {
+		return 0;
+	}
+
+	while (taken < count) {
+		head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+		if (queue->mode == LQUEUE_MPMC) {
+			/* The tail is read before the next, the tail is not behind
+			 * the head then and the head has a next if it is not the tail */
+			tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+		}
+		next = __atomic_load_n(&queue->nodes[LQUEUE_INDEX(head)].next, __ATOMIC_ACQUIRE);
+
+		if (queue->mode == LQUEUE_MPSC) {
+			/* Only this thread moves the head */
+			if (LQUEUE_INDEX(next) == LQUEUE_NULL) {
+				break;
+			}
+			if (copy) {
+				memcpy(copy, queue->nodes[LQUEUE_INDEX(next)].data, queue->typesize);
+			}
+			__atomic_store_n(&queue->head, LQUEUE_LINK(LQUEUE_INDEX(next),
+			                 LQUEUE_TAG(head) + 1), __ATOMIC_RELEASE);
+		} else {
+			if (head != __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE)) {
+				continue;
+			}
+			if (LQUEUE_INDEX(head) == LQUEUE_INDEX(tail)) {
+				if (LQUEUE_INDEX(next) == LQUEUE_NULL) {
+					break;
+				}
+				/* The tail is behind, help the enqueuing thread move it */
+				__atomic_compare_exchange_n(&queue->tail, &tail,
+				                            LQUEUE_LINK(LQUEUE_INDEX(next), LQUEUE_TAG(tail) + 1),
+				                            0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+				continue;
+			}
+
+			/* The data is read before taking the node, it is only used if
+			 * nobody took the node in between, which the tag makes sure of */
+			if (copy) {
+				memcpy(copy, queue->nodes[LQUEUE_INDEX(next)].data, queue->typesize);
+			}
+			if (!__atomic_compare_exchange_n(&queue->head, &head,
+			                                 LQUEUE_LINK(LQUEUE_INDEX(next), LQUEUE_TAG(head) + 1),
+			                                 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+				continue;
+			}
+		}
+
+		/* The old dummy is free, the node of the data is the new dummy */
+		give_lqnode(LQUEUE_INDEX(head), queue);
+		__atomic_fetch_sub(&queue->size, 1, __ATOMIC_RELAXED);
+		if (copy) {
+			copy += queue->typesize;
+		}
+		taken++;
+	}
+	return taken;
+}
+
+int delete_lqueue(struct lqueue_t *queue)
+{
+	if (!queue) {
+		return 1;
+	}
+
+	free(queue->nodes);
+	free(queue);
+	return 0;
+}
+
+
+
+uint32_t take_lqnode(struct lqueue_t *queue)
+{
+	uint64_t top = __atomic_load_n(&queue->free, __ATOMIC_ACQUIRE);
+	uint64_t next = 0;
+
+	while (LQUEUE_INDEX(top) != LQUEUE_NULL) {
+		next = __atomic_load_n(&queue->nodes[LQUEUE_INDEX(top)].free, __ATOMIC_RELAXED);
+		if (__atomic_compare_exchange_n(&queue->free, &top,
+		                                LQUEUE_LINK(LQUEUE_INDEX(next), LQUEUE_TAG(top) + 1),
+		                                0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+			return LQUEUE_INDEX(top);
+		}
+	}
+	return LQUEUE_NULL;
+}
+
+void give_lqnode(uint32_t index, struct lqueue_t *queue)
+{
+	uint64_t top = __atomic_load_n(&queue->free, __ATOMIC_RELAXED);
+
+	do {
+		__atomic_store_n(&queue->nodes[index].free, top, __ATOMIC_RELAXED);
+	} while (!__atomic_compare_exchange_n(&queue->free, &top,
+	                                      LQUEUE_LINK(index, LQUEUE_TAG(top) + 1),
+	                                      0, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+void link_lqnodes(uint32_t first, uint32_t last, struct lqueue_t *queue)
+{
+	uint64_t tail = 0;
+	uint64_t next = 0;
+
+	if (queue->mode == LQUEUE_MPSC) {
+		/* Taking the tail orders the producers, the consumer waits for
+		 * the next of the old tail to be set before it goes past it */
+		tail = __atomic_exchange_n(&queue->tail, LQUEUE_LINK(last, 0), __ATOMIC_ACQ_REL);
+		next = __atomic_load_n(&queue->nodes[LQUEUE_INDEX(tail)].next, __ATOMIC_RELAXED);
+		__atomic_store_n(&queue->nodes[LQUEUE_INDEX(tail)].next,
+		                 LQUEUE_LINK(first, LQUEUE_TAG(next) + 1), __ATOMIC_RELEASE);
+		return;
+	}
+
+	for (;;) {
+		tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+		next = __atomic_load_n(&queue->nodes[LQUEUE_INDEX(tail)].next, __ATOMIC_ACQUIRE);
+		if (tail != __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE)) {
+			continue;
+		}
+
+		/* The tail is behind, move it before linking */
+		if (LQUEUE_INDEX(next) != LQUEUE_NULL) {
+			__atomic_compare_exchange_n(&queue->tail, &tail,
+			                            LQUEUE_LINK(LQUEUE_INDEX(next), LQUEUE_TAG(tail) + 1),
+			                            0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+			continue;
+		}
+		if (__atomic_compare_exchange_n(&queue->nodes[LQUEUE_INDEX(tail)].next, &next,
+		                                LQUEUE_LINK(first, LQUEUE_TAG(next) + 1),
+		                                0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+			break;
+		}
+	}
+
+	/* Other threads move the tail over the batch if this fails */
+	__atomic_compare_exchange_n(&queue->tail, &tail, LQUEUE_LINK(last, LQUEUE_TAG(tail) + 1),
+	                            0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+/* LIST_IMPL */
+#endif
+
+/* LQUEUE_H */
+#endif
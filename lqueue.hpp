@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// The lock-free queue for the C++ Wrapper of the Minimal C Linked List
+//   Usage and other information is provided in the README.md file from the
+//   repository. Please refer to that to know how to use this library.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LQUEUE_HPP
+#define LQUEUE_HPP "lqueue.hpp"
+
+// This header is just a wrapper for the Minimal C Lock-Free Queue
+#include "lqueue.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace aplib
+{
+// A bounded queue for handing values between threads, pushing to a full
+// queue and popping from an empty queue fail instead of waiting
+template<typename type_t>
+class queue
+{
+	// Values are copied in and out of the nodes
+	static_assert(std::is_trivially_copyable<type_t>::value,
+	              "The values are copied, the type must be trivially copyable");
+	lqueue_t *internal_queue;
+public:
+	// The mode is LQUEUE_MPMC or LQUEUE_MPSC, only one thread pops then
+	explicit queue(size_t capacity, int mode = LQUEUE_MPMC);
+	~queue();
+	queue(const queue &other) = delete;
+	queue &operator=(const queue &other) = delete;
+
+	// The size changes while other threads use the queue
+	size_t size() const;
+	size_t capacity() const;
+
+	bool push(const type_t &value);
+	bool pop(type_t &value);
+	// Returns the number of values pushed or popped
+	size_t push(const type_t *values, size_t count);
+	size_t pop(type_t *values, size_t count);
+};
+}
+
+#ifdef LIST_IMPL
+
+template<typename type_t>
+aplib::queue<type_t>::queue(size_t capacity, int mode)
+{
+	internal_queue = create_lqueue(sizeof(type_t), capacity, mode);
+	if (!internal_queue) {
+		throw std::bad_alloc();
+	}
+}
+
+template<typename type_t>
+aplib::queue<type_t>::~queue()
+{
+	delete_lqueue(internal_queue);
+}
+
+template<typename type_t>
+size_t aplib::queue<type_t>::size() const
+{
+	return get_lqueue_size(internal_queue);
+}
+
+template<typename type_t>
+size_t aplib::queue<type_t>::capacity() const
+{
+	return internal_queue->capacity;
+}
+
+template<typename type_t>
+bool aplib::queue<type_t>::push(const type_t &value)
+{
+	return enqueue_lqueue(internal_queue, &value) == 0;
+}
+
+template<typename type_t>
+bool aplib::queue<type_t>::pop(type_t &value)
+{
+	return dequeue_lqueue(internal_queue, &value) == 0;
+}
+
+template<typename type_t>
+size_t aplib::queue<type_t>::push(const type_t *values, size_t count)
+{
+	return enqueue_lqueue_batch(internal_queue, values, count);
+}
+
+template<typename type_t>
+size_t aplib::queue<type_t>::pop(type_t *values, size_t count)
+{
+	return dequeue_lqueue_batch(internal_queue, values, count);
+}
+
+// LIST_IMPL
+#endif
+
+// LQUEUE_HPP
+#endif
@@ -0,0 +1,600 @@
+/*
+ * Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * A Minimal C Memory-Mapped Linked List
+ *   Usage and other information is provided in the README.md file from the
+ *   repository. Please refer to that to know how to use this library.
+ */
+
+#ifndef MLIST_H
+#define MLIST_H "mlist.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* The mapped list aligns its data like the list */
+#include "list.h"
+
+/* Implement the list code by defining
+ * LIST_IMPL before including this library */
+
+/* The mapped list is made for POSIX systems. The whole list lives in a
+ * file mapped into memory, the links are offsets from the beginning of
+ * the file instead of pointers, so opening the file again gives back the
+ * list as it was without reading or allocating any of its elements */
+
+#define MLIST_MAGIC "APMLIST"
+#define MLIST_VERSION 1
+
+/* The file grows by doubling, starting from this many bytes */
+#ifndef MLIST_INITIAL_LENGTH
+#define MLIST_INITIAL_LENGTH 4096
+#endif
+
+/* The header is at the beginning of the file, so an offset of 0 is used
+ * for no element. The elements are placed after it, every one of them
+ * takes element_size bytes and its data is at data_offset from it */
+struct mlist_header_t {
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+	uint64_t size;
+	uint64_t typesize;
+	uint64_t element_size;
+	uint64_t data_offset;
+	uint64_t head;
+	uint64_t tail;
+	/* Removed elements are linked through their next and reused */
+	uint64_t free;
+	/* The end of the elements handed out so far, and of the file */
+	uint64_t used;
+	uint64_t length;
+};
+
+/* Like the elements of the list, with an offset instead of a pointer */
+struct melement_t {
+	uint64_t next;
+};
+
+struct mlist_t {
+	/* The mapping of the file, it starts with the header. The file is
+	 * grown before the length in the header, so the mapped length is
+	 * kept here and the file can be longer than the header says */
+	struct mlist_header_t *header;
+	size_t mapped;
+	int fd;
+	/* The last accessed element and its index, they are not saved */
+	uint64_t cursor;
+	size_t cursor_index;
+};
+
+
+/* Creates the file, or empties it if it already exists */
+struct mlist_t *create_mlist(const char *path, size_t typesize);
+/* Maps an existing file without reading the elements, NULL is
+ * returned if the file does not hold a list of this version */
+struct mlist_t *open_mlist(const char *path);
+
+/* The data of the elements is given instead of the elements, do not keep
+ * it after adding because the file is mapped again when it grows */
+void *get_melement(size_t index, struct mlist_t *list);
+size_t get_mlist_size(struct mlist_t *list);
+
+/* Define LIST_DEBUG to check the size, tail,
+ * free elements and links of a list */
+#ifdef LIST_DEBUG
+int mlist_verify(struct mlist_t *list);
+#endif
+
+/* These functions are not supposed to be used externally */
+int check_mlist_header(const struct mlist_header_t *header, uint64_t length);
+int check_mlist_offset(uint64_t offset, const struct mlist_header_t *header);
+struct melement_t *get_mlist_element(uint64_t offset, struct mlist_t *list);
+uint64_t find_melement(size_t index, struct mlist_t *list);
+uint64_t create_melement(struct mlist_t *list);
+int map_mlist(size_t length, struct mlist_t *list);
+
+/* You can add element at the end of the
+ * list by giving it the size of the list */
+void *add_melement(size_t index, struct mlist_t *list);
+int remove_melement(size_t index, struct mlist_t *list);
+
+/* Writes the changes to the file and waits for it, a checkpoint after
+ * which the list is kept even if the system crashes */
+int sync_mlist(struct mlist_t *list);
+
+/* The file is shrunk back to the header */
+int clear_mlist(struct mlist_t *list);
+/* Unmaps and closes the file, the list stays in it */
+int close_mlist(struct mlist_t *list);
+
+#ifdef LIST_IMPL
+
+struct mlist_t *create_mlist(const char *path, size_t typesize)
+{
+	struct mlist_t *list = NULL;
+	struct mlist_header_t *header = NULL;
+	size_t align = 0;
+	size_t first = 0;
+
+	if (!path || !typesize) {
+		return NULL;
+	}
+	list = (struct mlist_t *) malloc(sizeof(struct mlist_t));
+	if (!list) {
+		return NULL;
+	}
+
+	list->header = NULL;
+	list->mapped = 0;
+	list->cursor = 0;
+	list->cursor_index = 0;
+	list->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (list->fd < 0) {
+		free(list);
+		return NULL;
+	}
+	if (map_mlist(MLIST_INITIAL_LENGTH, list)) {
+		close(list->fd);
+		free(list);
+		return NULL;
+	}
+
+	/* Elements are aligned for their data and their next offset, the
+	 * first one is placed after the header at the maximum alignment */
+	align = align_data_offset(1, typesize);
+	if (align < sizeof(uint64_t)) {
+		align = sizeof(uint64_t);
+	}
+	first = align_data_offset(sizeof(struct mlist_header_t), 0);
+
+	header = list->header;
+	memcpy(header->magic, MLIST_MAGIC, sizeof(header->magic));
+	header->version = MLIST_VERSION;
+	header->reserved = 0;
+	header->size = 0;
+	header->typesize = typesize;
+	header->data_offset = align_data_offset(sizeof(struct melement_t), typesize);
+	header->element_size = (header->data_offset + typesize + align - 1)
+	                       & ~(uint64_t) (align - 1);
+	header->head = 0;
+	header->tail = 0;
+	header->free = 0;
+	header->used = first;
+	header->length = MLIST_INITIAL_LENGTH;
+	return list;
+}
+
+struct mlist_t *open_mlist(const char *path)
+{
+	struct mlist_t *list = NULL;
+	struct mlist_header_t *header = NULL;
+	struct stat status;
+
+	if (!path) {
+		return NULL;
+	}
+	list = (struct mlist_t *) malloc(sizeof(struct mlist_t));
+	if (!list) {
+		return NULL;
+	}
+
+	list->header = NULL;
+	list->mapped = 0;
+	list->cursor = 0;
+	list->cursor_index = 0;
+	list->fd = open(path, O_RDWR);
+	if (list->fd < 0) {
+		free(list);
+		return NULL;
+	}
+	if (fstat(list->fd, &status) || (size_t) status.st_size
+	    < sizeof(struct mlist_header_t) || map_mlist(status.st_size, list)) {
+		close(list->fd);
+		free(list);
+		return NULL;
+	}
+
+	/* The file is longer if it was grown and the length was not written
+	 * after, the list is whole and the file keeps its length */
+	header = list->header;
+	if (check_mlist_header(header, (uint64_t) status.st_size)) {
+		munmap((void *) header, status.st_size);
+		close(list->fd);
+		free(list);
+		return NULL;
+	}
+	header->length = (uint64_t) status.st_size;
+	return list;
+}
+
+void *get_melement(size_t index, struct mlist_t *list)
+{
+	uint64_t offset = 0;
+
+	if (!list) {
+		return NULL;
+	}
+
+	offset = find_melement(index, list);
+	if (!offset || index == (size_t) -1) {
+		return NULL;
+	}
+	return (char *) get_mlist_element(offset, list) + list->header->data_offset;
+}
+
+size_t get_mlist_size(struct mlist_t *list)
+{
+	if (!list) {
+		return 0;
+	}
+	return list->header->size;
+}
+
+#ifdef LIST_DEBUG
+int mlist_verify(struct mlist_t *list)
+{
+	struct mlist_header_t *header = NULL;
+	uint64_t offset = 0;
+	uint64_t last = 0;
+	size_t size = 0;
+	size_t free_count = 0;
+
+	if (!list) {
+		return 1;
+	}
+	header = list->header;
+
+	/* Stop after the elements handed out are exceeded, in case
+	 * the links have a loop */
+	for (offset = header->head; offset; offset = get_mlist_element(offset,
+	        list)->next) {
+		if (offset >= header->used || size > header->used / header->element_size) {
+			return 2;
+		}
+		if (list->cursor && offset == list->cursor && size != list->cursor_index) {
+			return 3;
+		}
+		last = offset;
+		size++;
+	}
+	if (size != header->size) {
+		return 4;
+	}
+	if (header->tail != last) {
+		return 5;
+	}
+
+	for (offset = header->free; offset; offset = get_mlist_element(offset,
+	        list)->next) {
+		if (offset >= header->used || free_count > header->used / header->element_size) {
+			return 6;
+		}
+		free_count++;
+	}
+	return 0;
+}
+#endif
+
+
+
+int check_mlist_header(const struct mlist_header_t *header, uint64_t length)
+{
+	uint64_t first = align_data_offset(sizeof(struct mlist_header_t), 0);
+
+	if (memcmp(header->magic, MLIST_MAGIC, sizeof(header->magic))
+	    || header->version != MLIST_VERSION) {
+		return 2;
+	}
+
+	/* The elements are placed one after another from the first offset
+	 * up to the used offset, which is inside the file */
+	if (header->length > length || header->used > header->length
+	    || header->used < first) {
+		return 3;
+	}
+	if (!header->typesize || !header->element_size
+	    || header->element_size % sizeof(uint64_t)
+	    || header->data_offset < sizeof(struct melement_t)
+	    || header->data_offset > header->element_size
+	    || header->typesize > header->element_size - header->data_offset
+	    || (header->used - first) % header->element_size) {
+		return 4;
+	}
+	if (header->size > (header->used - first) / header->element_size
+	    || !header->head != !header->size || !header->tail != !header->size) {
+		return 5;
+	}
+
+	/* The links of the elements are not read, only those in the header */
+	if (check_mlist_offset(header->head, header)
+	    || check_mlist_offset(header->tail, header)
+	    || check_mlist_offset(header->free, header)) {
+		return 6;
+	}
+	return 0;
+}
+
+int check_mlist_offset(uint64_t offset, const struct mlist_header_t *header)
+{
+	uint64_t first = align_data_offset(sizeof(struct mlist_header_t), 0);
+
+	/* No element is given by 0 */
+	if (!offset) {
+		return 0;
+	}
+	if (offset < first || offset >= header->used
+	    || (offset - first) % header->element_size) {
+		return 1;
+	}
+	return 0;
+}
+
+struct melement_t *get_mlist_element(uint64_t offset, struct mlist_t *list)
+{
+	return (struct melement_t *) ((char *) list->header + offset);
+}
+
+uint64_t find_melement(size_t index, struct mlist_t *list)
+{
+	struct mlist_header_t *header = list->header;
+	uint64_t offset = 0;
+	size_t i = 0;
+
+	/* Index of -1 gives no element, the links before
+	 * the index of 0 are the ones in the header */
+	if (index == (size_t) -1) {
+		return 0;
+	}
+	if (index >= header->size) {
+		return 0;
+	}
+	if (index == header->size - 1) {
+		return header->tail;
+	}
+
+	/* Continue from the last accessed element if it
+	 * is not past the index, else start from the head */
+	if (list->cursor && list->cursor_index <= index) {
+		offset = list->cursor;
+		i = list->cursor_index;
+	} else {
+		offset = header->head;
+	}
+
+	for (; i < index; i++) {
+		offset = get_mlist_element(offset, list)->next;
+		if (!offset) {
+			return 0;
+		}
+	}
+
+	list->cursor = offset;
+	list->cursor_index = index;
+	return offset;
+}
+
+uint64_t create_melement(struct mlist_t *list)
+{
+	struct mlist_header_t *header = list->header;
+	uint64_t offset = header->free;
+	size_t length = 0;
+
+	if (offset) {
+		header->free = get_mlist_element(offset, list)->next;
+		return offset;
+	}
+
+	/* The file doubles when the elements do not fit anymore */
+	if (header->used + header->element_size > header->length) {
+		length = header->length * 2;
+		while (header->used + header->element_size > length) {
+			length *= 2;
+		}
+		if (map_mlist(length, list)) {
+			return 0;
+		}
+		header = list->header;
+		header->length = length;
+	}
+
+	offset = header->used;
+	header->used += header->element_size;
+	return offset;
+}
+
+int map_mlist(size_t length, struct mlist_t *list)
+{
+	void *mapping = NULL;
+
+	/* The file is grown before it is mapped again, the offsets
+	 * stay the same wherever the mapping ends up */
+	if (ftruncate(list->fd, (off_t) length)) {
+		return 2;
+	}
+	mapping = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, list->fd, 0);
+	if (mapping == MAP_FAILED) {
+		/* The old mapping is used again, it needs the old length */
+		if (list->header && ftruncate(list->fd, (off_t) list->mapped)) {
+			return 4;
+		}
+		return 3;
+	}
+	if (list->header) {
+		munmap((void *) list->header, list->mapped);
+	}
+	list->header = (struct mlist_header_t *) mapping;
+	list->mapped = length;
+	return 0;
+}
+
+
+
+void *add_melement(size_t index, struct mlist_t *list)
+{
+	struct mlist_header_t *header = NULL;
+	struct melement_t *new_element = NULL;
+	uint64_t *prev_next = NULL;
+	uint64_t prev = 0;
+	uint64_t offset = 0;
+
+	if (!list) {
+		return NULL;
+	}
+	if (index > list->header->size) {
+		return NULL;
+	}
+
+	/* The element is taken before finding the previous one, because
+	 * the file may be mapped again and move the links */
+	offset = create_melement(list);
+	if (!offset) {
+		return NULL;
+	}
+	header = list->header;
+
+	/* Adding at the end gets the tail, no walking is done */
+	prev = find_melement(index - 1, list);
+	prev_next = prev ? &get_mlist_element(prev, list)->next : &header->head;
+
+	new_element = get_mlist_element(offset, list);
+	new_element->next = *prev_next;
+	*prev_next = offset;
+	if (!new_element->next) {
+		header->tail = offset;
+	}
+
+	/* The elements after the index have moved, so
+	 * the new element becomes the last accessed */
+	list->cursor = offset;
+	list->cursor_index = index;
+
+	header->size++;
+	return (char *) new_element + header->data_offset;
+}
+
+int remove_melement(size_t index, struct mlist_t *list)
+{
+	struct mlist_header_t *header = NULL;
+	struct melement_t *element = NULL;
+	uint64_t *prev_next = NULL;
+	uint64_t prev = 0;
+	uint64_t offset = 0;
+
+	if (!list) {
+		return 1;
+	}
+	header = list->header;
+	if (index >= header->size) {
+		return 3;
+	}
+
+	prev = find_melement(index - 1, list);
+	prev_next = prev ? &get_mlist_element(prev, list)->next : &header->head;
+	offset = *prev_next;
+	if (!offset) {
+		return 4;
+	}
+	element = get_mlist_element(offset, list);
+
+	*prev_next = element->next;
+	if (header->tail == offset) {
+		header->tail = prev;
+	}
+
+	/* The previous element keeps its index, the header is not cached */
+	list->cursor = prev;
+	list->cursor_index = index - 1;
+
+	element->next = header->free;
+	header->free = offset;
+	header->size--;
+	return 0;
+}
+
+
+
+int sync_mlist(struct mlist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (msync((void *) list->header, list->mapped, MS_SYNC)) {
+		return 2;
+	}
+	return 0;
+}
+
+int clear_mlist(struct mlist_t *list)
+{
+	struct mlist_header_t *header = NULL;
+
+	if (!list) {
+		return 1;
+	}
+	/* The list is emptied before the file is shrunk, so that the header
+	 * never has a length past the end of the file */
+	header = list->header;
+	header->size = 0;
+	header->head = 0;
+	header->tail = 0;
+	header->free = 0;
+	header->used = align_data_offset(sizeof(struct mlist_header_t), 0);
+	header->length = MLIST_INITIAL_LENGTH;
+	list->cursor = 0;
+	list->cursor_index = 0;
+
+	if (list->mapped > MLIST_INITIAL_LENGTH
+	    && map_mlist(MLIST_INITIAL_LENGTH, list)) {
+		/* The file keeps its length, which open_mlist accepts */
+		header->length = list->mapped;
+		return 2;
+	}
+	return 0;
+}
+
+int close_mlist(struct mlist_t *list)
+{
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+	if (munmap((void *) list->header, list->mapped)) {
+		error = 2;
+	}
+	if (close(list->fd)) {
+		error = 3;
+	}
+
+	free(list);
+	return error;
+}
+
+/* LIST_IMPL */
+#endif
+
+/* MLIST_H */
+#endif
@@ -0,0 +1,348 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Parallel algorithms for the C++ Wrapper of the Minimal C Linked List
+//   Usage and other information is provided in the README.md file from the
+//   repository. Please refer to that to know how to use this library.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP "parallel.hpp"
+
+#include "list.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace aplib
+{
+namespace parallel
+{
+// The smallest number of elements given to a thread at once
+constexpr size_t minimum_segment = 4096;
+// Every thread gets this many segments on average, so that threads
+// finishing early take the segments of the slower ones
+constexpr size_t segments_per_thread = 4;
+
+// A pool keeps its threads between the algorithms. The thread running
+// the tasks works on them as well, so a pool of one thread has no threads
+class pool
+{
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	// Only one run at a time, the tasks must not run the same pool
+	std::mutex running;
+
+	const std::function<void(size_t)> *task = nullptr;
+	size_t count = 0;
+	std::atomic<size_t> next {0};
+	size_t generation = 0;
+	size_t working = 0;
+	bool stopping = false;
+	std::exception_ptr error;
+
+	void work();
+	void take_tasks();
+public:
+	// The number of threads including the one running the tasks
+	explicit pool(size_t size = std::thread::hardware_concurrency());
+	~pool();
+	pool(const pool &other) = delete;
+	pool &operator=(const pool &other) = delete;
+
+	size_t size() const;
+	// Runs the task for every index below the count, the threads take the
+	// next index when they are done. The first exception is thrown again
+	void run(size_t count, const std::function<void(size_t)> &task);
+
+	// The pool used by the algorithms when they are not given one
+	static pool &shared();
+};
+
+// Splits the list into segments of about the same number of elements,
+// given as pairs of iterators that can be used by any thread (and with
+// std::execution::par). Finding them walks the list once at most, and
+// skips over chunks or goes down the tree for the other backends
+template<typename list_t>
+std::vector<std::pair<typename list_t::iterator, typename list_t::iterator>>
+segments(list_t &values, size_t count);
+// The number of segments the algorithms split a list of the size into
+size_t count_segments(size_t size, pool &workers);
+
+// The list must not be changed while these run, and the functions must
+// not access the list by index since it moves the last accessed element
+template<typename list_t, typename function_t>
+void for_each(list_t &values, function_t function,
+              pool &workers = pool::shared());
+// Replaces every value of the output with the function of the value at
+// the same index of the input, both lists must have the same size
+template<typename input_t, typename output_t, typename function_t>
+void transform(input_t &input, output_t &output, function_t function,
+               pool &workers = pool::shared());
+// The operation must be associative, the values are combined in order
+template<typename list_t, typename value_t, typename operation_t>
+value_t reduce(list_t &values, value_t initial, operation_t operation,
+               pool &workers = pool::shared());
+template<typename list_t, typename predicate_t>
+size_t count_if(list_t &values, predicate_t predicate,
+                pool &workers = pool::shared());
+}
+}
+
+#ifdef LIST_IMPL
+
+aplib::parallel::pool::pool(size_t size)
+{
+	// Zero is given if the number of processors is not known
+	for (size_t i = 1; i < size; i++) {
+		threads.emplace_back(&pool::work, this);
+	}
+}
+
+aplib::parallel::pool::~pool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+}
+
+size_t aplib::parallel::pool::size() const
+{
+	return threads.size() + 1;
+}
+
+void aplib::parallel::pool::run(size_t count,
+                                const std::function<void(size_t)> &task)
+{
+	std::lock_guard<std::mutex> run_lock(running);
+	std::exception_ptr thrown;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->task = &task;
+		this->count = count;
+		next.store(0, std::memory_order_relaxed);
+		error = nullptr;
+		working = threads.size();
+		generation++;
+	}
+	wake.notify_all();
+	take_tasks();
+
+	// The task is kept by the caller until every thread is done with it
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this]() {
+			return working == 0;
+		});
+		thrown = error;
+		this->task = nullptr;
+	}
+	if (thrown) {
+		std::rethrow_exception(thrown);
+	}
+}
+
+aplib::parallel::pool &aplib::parallel::pool::shared()
+{
+	static pool workers;
+	return workers;
+}
+
+void aplib::parallel::pool::work()
+{
+	size_t seen = 0;
+
+	for (;;) {
+		std::unique_lock<std::mutex> lock(mutex);
+		wake.wait(lock, [this, seen]() {
+			return stopping || generation != seen;
+		});
+		if (stopping) {
+			return;
+		}
+		seen = generation;
+		lock.unlock();
+
+		take_tasks();
+
+		lock.lock();
+		if (--working == 0) {
+			done.notify_one();
+		}
+	}
+}
+
+void aplib::parallel::pool::take_tasks()
+{
+	size_t index = 0;
+
+	while ((index = next.fetch_add(1, std::memory_order_relaxed)) < count) {
+		try {
+			(*task)(index);
+		} catch (...) {
+			// The remaining tasks are skipped after an exception
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!error) {
+				error = std::current_exception();
+			}
+			next.store(count, std::memory_order_relaxed);
+		}
+	}
+}
+
+size_t aplib::parallel::count_segments(size_t size, pool &workers)
+{
+	size_t count = size / minimum_segment;
+
+	if (count == 0) {
+		return 1;
+	}
+	if (count > workers.size() * segments_per_thread) {
+		return workers.size() * segments_per_thread;
+	}
+	return count;
+}
+
+template<typename list_t>
+std::vector<std::pair<typename list_t::iterator, typename list_t::iterator>>
+aplib::parallel::segments(list_t &values, size_t count)
+{
+	std::vector<std::pair<typename list_t::iterator, typename list_t::iterator>> found;
+	size_t size = values.size();
+
+	if (count > size) {
+		count = size;
+	}
+
+	// The indices increase, so a linked list continues from the last one
+	for (size_t i = 0; i < count; i++) {
+		found.emplace_back(values.nth(size * i / count), values.end());
+		if (i > 0) {
+			found[i - 1].second = found[i].first;
+		}
+	}
+	return found;
+}
+
+template<typename list_t, typename function_t>
+void aplib::parallel::for_each(list_t &values, function_t function,
+                               pool &workers)
+{
+	auto found = segments(values, count_segments(values.size(), workers));
+
+	workers.run(found.size(), [&found, &function](size_t index) {
+		for (auto value = found[index].first; value != found[index].second; ++value) {
+			function(*value);
+		}
+	});
+}
+
+template<typename input_t, typename output_t, typename function_t>
+void aplib::parallel::transform(input_t &input, output_t &output,
+                                function_t function, pool &workers)
+{
+	auto found = segments(input, count_segments(input.size(), workers));
+	std::vector<typename output_t::iterator> outputs;
+
+	if (input.size() != output.size()) {
+		throw std::invalid_argument("aplib::parallel::transform");
+	}
+
+	// The output is split at the same indices as the input
+	for (size_t i = 0; i < found.size(); i++) {
+		outputs.push_back(output.nth(input.size() * i / found.size()));
+	}
+
+	workers.run(found.size(), [&found, &outputs, &function](size_t index) {
+		auto result = outputs[index];
+		for (auto value = found[index].first; value != found[index].second;
+		     ++value, ++result) {
+			*result = function(*value);
+		}
+	});
+}
+
+template<typename list_t, typename value_t, typename operation_t>
+value_t aplib::parallel::reduce(list_t &values, value_t initial,
+                                operation_t operation, pool &workers)
+{
+	auto found = segments(values, count_segments(values.size(), workers));
+	std::vector<value_t> results(found.size(), initial);
+
+	// Every segment starts from its first value, so that the initial
+	// value is only combined once and needs not be the identity
+	workers.run(found.size(), [&found, &results, &operation](size_t index) {
+		auto value = found[index].first;
+		value_t result = *value;
+		for (++value; value != found[index].second; ++value) {
+			result = operation(std::move(result), *value);
+		}
+		results[index] = std::move(result);
+	});
+
+	for (value_t &result : results) {
+		initial = operation(std::move(initial), std::move(result));
+	}
+	return initial;
+}
+
+template<typename list_t, typename predicate_t>
+size_t aplib::parallel::count_if(list_t &values, predicate_t predicate,
+                                 pool &workers)
+{
+	auto found = segments(values, count_segments(values.size(), workers));
+	std::vector<size_t> counts(found.size(), 0);
+	size_t total = 0;
+
+	workers.run(found.size(), [&found, &counts, &predicate](size_t index) {
+		size_t counted = 0;
+		for (auto value = found[index].first; value != found[index].second; ++value) {
+			counted += predicate(*value) ? 1 : 0;
+		}
+		counts[index] = counted;
+	});
+
+	for (size_t counted : counts) {
+		total += counted;
+	}
+	return total;
+}
+
+// LIST_IMPL
+#endif
+
+// PARALLEL_HPP
+#endif
@@ -0,0 +1,507 @@
+/*
+ * Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Vectorized searching and reducing for the Minimal C Unrolled Linked List
+ *   Usage and other information is provided in the README.md file from the
+ *   repository. Please refer to that to know how to use this library.
+ */
+
+#ifndef SCAN_H
+#define SCAN_H "scan.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* The elements of an unrolled list are next to each other in chunks */
+#include "ulist.h"
+
+/* Implement the list code by defining
+ * LIST_IMPL before including this library */
+
+/* The kernels work on arrays of numbers, one chunk of an unrolled list at
+ * a time. They are written using the vector extensions of GCC and Clang
+ * with vectors of 64 bytes, which are split into the vectors the processor
+ * has. On x86-64 every kernel is compiled for AVX-512, AVX2 and the
+ * default of SSE2, and the one for the processor is chosen when the
+ * program is loaded. Other compilers use loops of single elements */
+
+#define LIST_INT32 0
+#define LIST_FLOAT 1
+#define LIST_DOUBLE 2
+#define LIST_UINT64 3
+
+#define LIST_SUM 0
+#define LIST_MIN 1
+#define LIST_MAX 2
+
+#if defined(__GNUC__) && (__GNUC__ >= 9 || defined(__clang__))
+#define LIST_VECTORS 1
+#if defined(__x86_64__) && defined(__ELF__) && !defined(LIST_NO_CLONES)
+#define LIST_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+#endif
+
+#ifndef LIST_CLONES
+#define LIST_CLONES
+#endif
+
+/* The number of elements of a type in a vector */
+#define LIST_LANES(type_t) (64 / sizeof(type_t))
+
+/* Finding gives the index of the first element equal to the value, or the
+ * size if there is none. Sums of int32 are int64, sums of float are double
+ * and the others are of the same type, in any order. The minimum and the
+ * maximum of an empty list are not given, 2 is returned for them. If the
+ * typesize of the list is not the size of the type, nothing is found or
+ * counted and reducing returns 4 */
+size_t find_uvalue(const void *value, int type, struct ulist_t *list);
+size_t count_uvalues(const void *value, int type, struct ulist_t *list);
+int reduce_uvalues(int reduction, int type, void *result, struct ulist_t *list);
+
+/* The size of an element of the type, 0 for an unknown type */
+size_t get_scan_typesize(int type);
+
+/* The kernels for arrays of every type, they can be used for any array.
+ * The minimum and the maximum need at least one element */
+size_t find_int32_values(const int32_t *data, size_t count, int32_t value);
+size_t count_int32_values(const int32_t *data, size_t count, int32_t value);
+int64_t sum_int32_values(const int32_t *data, size_t count);
+int32_t min_int32_values(const int32_t *data, size_t count);
+int32_t max_int32_values(const int32_t *data, size_t count);
+
+size_t find_float_values(const float *data, size_t count, float value);
+size_t count_float_values(const float *data, size_t count, float value);
+double sum_float_values(const float *data, size_t count);
+float min_float_values(const float *data, size_t count);
+float max_float_values(const float *data, size_t count);
+
+size_t find_double_values(const double *data, size_t count, double value);
+size_t count_double_values(const double *data, size_t count, double value);
+double sum_double_values(const double *data, size_t count);
+double min_double_values(const double *data, size_t count);
+double max_double_values(const double *data, size_t count);
+
+size_t find_uint64_values(const uint64_t *data, size_t count, uint64_t value);
+size_t count_uint64_values(const uint64_t *data, size_t count, uint64_t value);
+uint64_t sum_uint64_values(const uint64_t *data, size_t count);
+uint64_t min_uint64_values(const uint64_t *data, size_t count);
+uint64_t max_uint64_values(const uint64_t *data, size_t count);
+
+#ifdef LIST_IMPL
+
+#ifdef LIST_VECTORS
+
+/* Comparing vectors gives masks of integers of the same size as the
+ * elements, all bits are set where it is true. The sums are added in
+ * vectors of the sum type, loaded from as many elements as they hold */
+#define LIST_SCAN_KERNELS(name, type_t, mask_t, sum_t) \
+typedef type_t name##_vector_t __attribute__((vector_size(64))); \
+typedef mask_t name##_mask_t __attribute__((vector_size(64))); \
+typedef sum_t name##_sum_vector_t __attribute__((vector_size(64))); \
+typedef type_t name##_narrow_vector_t \
+        __attribute__((vector_size(64 / sizeof(sum_t) * sizeof(type_t)))); \
+\
+LIST_CLONES size_t find_##name##_values(const type_t *data, size_t count, \
+                                        type_t value) \
+{ \
+	name##_vector_t vector; \
+	name##_mask_t equal; \
+	uint64_t words[8]; \
+	size_t i = 0; \
+\
+	for (; i + LIST_LANES(type_t) <= count; i += LIST_LANES(type_t)) { \
+		memcpy(&vector, data + i, sizeof(vector)); \
+		equal = vector == value; \
+		memcpy(words, &equal, sizeof(words)); \
+		if (words[0] | words[1] | words[2] | words[3] \
+		    | words[4] | words[5] | words[6] | words[7]) { \
+			break; \
+		} \
+	} \
+	for (; i < count; i++) { \
+		if (data[i] == value) { \
+			return i; \
+		} \
+	} \
+	return count; \
+} \
+\
+LIST_CLONES size_t count_##name##_values(const type_t *data, size_t count, \
+                                         type_t value) \
+{ \
+	name##_vector_t vector; \
+	name##_mask_t counts = {0}; \
+	name##_mask_t zero = {0}; \
+	size_t total = 0; \
+	size_t block = 0; \
+	size_t i = 0; \
+	size_t lane = 0; \
+\
+	/* The counts of the lanes are added up before they overflow */ \
+	for (; i + LIST_LANES(type_t) <= count; i += LIST_LANES(type_t)) { \
+		memcpy(&vector, data + i, sizeof(vector)); \
+		counts -= (name##_mask_t) (vector == value); \
+		if (++block == 65536) { \
+			for (lane = 0; lane < LIST_LANES(type_t); lane++) { \
+				total += (size_t) counts[lane]; \
+			} \
+			counts = zero; \
+			block = 0; \
+		} \
+	} \
+\
+	for (lane = 0; lane < LIST_LANES(type_t); lane++) { \
+		total += (size_t) counts[lane]; \
+	} \
+	for (; i < count; i++) { \
+		total += data[i] == value; \
+	} \
+	return total; \
+} \
+\
+LIST_CLONES sum_t sum_##name##_values(const type_t *data, size_t count) \
+{ \
+	name##_narrow_vector_t vector; \
+	name##_sum_vector_t sums = {0}; \
+	sum_t total = 0; \
+	size_t i = 0; \
+	size_t lane = 0; \
+\
+	for (; i + LIST_LANES(sum_t) <= count; i += LIST_LANES(sum_t)) { \
+		memcpy(&vector, data + i, sizeof(vector)); \
+		sums += __builtin_convertvector(vector, name##_sum_vector_t); \
+	} \
+	for (lane = 0; lane < LIST_LANES(sum_t); lane++) { \
+		total += sums[lane]; \
+	} \
+	for (; i < count; i++) { \
+		total += (sum_t) data[i]; \
+	} \
+	return total; \
+} \
+\
+LIST_CLONES type_t min_##name##_values(const type_t *data, size_t count) \
+{ \
+	name##_vector_t vector; \
+	name##_vector_t best; \
+	name##_mask_t less; \
+	type_t result = data[0]; \
+	size_t i = 0; \
+	size_t lane = 0; \
+\
+	/* Lanes are chosen using the masks, the elements keep their bits */ \
+	if (count >= LIST_LANES(type_t)) { \
+		memcpy(&best, data, sizeof(best)); \
+		for (i = LIST_LANES(type_t); i + LIST_LANES(type_t) <= count; \
+		     i += LIST_LANES(type_t)) { \
+			memcpy(&vector, data + i, sizeof(vector)); \
+			less = (name##_mask_t) (vector < best); \
+			best = (name##_vector_t) (((name##_mask_t) vector & less) \
+			                          | ((name##_mask_t) best & ~less)); \
+		} \
+		for (lane = 0; lane < LIST_LANES(type_t); lane++) { \
+			result = best[lane] < result ? best[lane] : result; \
+		} \
+	} \
+	for (; i < count; i++) { \
+		result = data[i] < result ? data[i] : result; \
+	} \
+	return result; \
+} \
+\
+LIST_CLONES type_t max_##name##_values(const type_t *data, size_t count) \
+{ \
+	name##_vector_t vector; \
+	name##_vector_t best; \
+	name##_mask_t greater; \
+	type_t result = data[0]; \
+	size_t i = 0; \
+	size_t lane = 0; \
+\
+	if (count >= LIST_LANES(type_t)) { \
+		memcpy(&best, data, sizeof(best)); \
+		for (i = LIST_LANES(type_t); i + LIST_LANES(type_t) <= count; \
+		     i += LIST_LANES(type_t)) { \
+			memcpy(&vector, data + i, sizeof(vector)); \
+			greater = (name##_mask_t) (vector > best); \
+			best = (name##_vector_t) (((name##_mask_t) vector & greater) \
+			                          | ((name##_mask_t) best & ~greater)); \
+		} \
+		for (lane = 0; lane < LIST_LANES(type_t); lane++) { \
+			result = best[lane] > result ? best[lane] : result; \
+		} \
+	} \
+	for (; i < count; i++) { \
+		result = data[i] > result ? data[i] : result; \
+	} \
+	return result; \
+}
+
+#else
+
+#define LIST_SCAN_KERNELS(name, type_t, mask_t, sum_t) \
+size_t find_##name##_values(const type_t *data, size_t count, type_t value) \
+{ \
+	size_t i = 0; \
+\
+	for (; i < count; i++) { \
+		if (data[i] == value) { \
+			return i; \
+		} \
+	} \
+	return count; \
+} \
+\
+size_t count_##name##_values(const type_t *data, size_t count, type_t value) \
+{ \
+	size_t total = 0; \
+	size_t i = 0; \
+\
+	for (; i < count; i++) { \
+		total += data[i] == value; \
+	} \
+	return total; \
+} \
+\
+sum_t sum_##name##_values(const type_t *data, size_t count) \
+{ \
+	sum_t total = 0; \
+	size_t i = 0; \
+\
+	for (; i < count; i++) { \
+		total += (sum_t) data[i]; \
+	} \
+	return total; \
+} \
+\
+type_t min_##name##_values(const type_t *data, size_t count) \
+{ \
+	type_t result = data[0]; \
+	size_t i = 1; \
+\
+	for (; i < count; i++) { \
+		result = data[i] < result ? data[i] : result; \
+	} \
+	return result; \
+} \
+\
+type_t max_##name##_values(const type_t *data, size_t count) \
+{ \
+	type_t result = data[0]; \
+	size_t i = 1; \
+\
+	for (; i < count; i++) { \
+		result = data[i] > result ? data[i] : result; \
+	} \
+	return result; \
+}
+
+#endif
+
+LIST_SCAN_KERNELS(int32, int32_t, int32_t, int64_t)
+LIST_SCAN_KERNELS(float, float, int32_t, double)
+LIST_SCAN_KERNELS(double, double, int64_t, double)
+LIST_SCAN_KERNELS(uint64, uint64_t, int64_t, uint64_t)
+
+size_t get_scan_typesize(int type)
+{
+	switch (type) {
+	case LIST_INT32:
+		return sizeof(int32_t);
+	case LIST_FLOAT:
+		return sizeof(float);
+	case LIST_DOUBLE:
+		return sizeof(double);
+	case LIST_UINT64:
+		return sizeof(uint64_t);
+	default:
+		return 0;
+	}
+}
+
+size_t find_uvalue(const void *value, int type, struct ulist_t *list)
+{
+	struct uchunk_t *chunk = NULL;
+	const void *data = NULL;
+	size_t first = 0;
+	size_t found = 0;
+
+	if (!list || !value) {
+		return 0;
+	}
+	if (get_scan_typesize(type) != list->typesize) {
+		return list->size;
+	}
+
+	for (chunk = list->head; chunk; chunk = (struct uchunk_t *) chunk->next) {
+		data = get_uchunk_data(chunk, 0, list);
+		switch (type) {
+		case LIST_INT32:
+			found = find_int32_values((const int32_t *) data, chunk->count,
+			                          *(const int32_t *) value);
+			break;
+		case LIST_FLOAT:
+			found = find_float_values((const float *) data, chunk->count,
+			                          *(const float *) value);
+			break;
+		case LIST_DOUBLE:
+			found = find_double_values((const double *) data, chunk->count,
+			                           *(const double *) value);
+			break;
+		case LIST_UINT64:
+			found = find_uint64_values((const uint64_t *) data, chunk->count,
+			                           *(const uint64_t *) value);
+			break;
+		default:
+			return list->size;
+		}
+		if (found < chunk->count) {
+			return first + found;
+		}
+		first += chunk->count;
+	}
+	return list->size;
+}
+
+size_t count_uvalues(const void *value, int type, struct ulist_t *list)
+{
+	struct uchunk_t *chunk = NULL;
+	const void *data = NULL;
+	size_t total = 0;
+
+	if (!list || !value) {
+		return 0;
+	}
+	if (get_scan_typesize(type) != list->typesize) {
+		return 0;
+	}
+
+	for (chunk = list->head; chunk; chunk = (struct uchunk_t *) chunk->next) {
+		data = get_uchunk_data(chunk, 0, list);
+		switch (type) {
+		case LIST_INT32:
+			total += count_int32_values((const int32_t *) data, chunk->count,
+			                            *(const int32_t *) value);
+			break;
+		case LIST_FLOAT:
+			total += count_float_values((const float *) data, chunk->count,
+			                            *(const float *) value);
+			break;
+		case LIST_DOUBLE:
+			total += count_double_values((const double *) data, chunk->count,
+			                             *(const double *) value);
+			break;
+		case LIST_UINT64:
+			total += count_uint64_values((const uint64_t *) data, chunk->count,
+			                             *(const uint64_t *) value);
+			break;
+		default:
+			return 0;
+		}
+	}
+	return total;
+}
+
+/* Every chunk is reduced by the kernel, and the results of the chunks
+ * are reduced the same way into the result */
+#define LIST_REDUCE_CHUNKS(name, type_t, sum_t) \
+	do { \
+		sum_t sum = 0; \
+		type_t best = *(const type_t *) get_uchunk_data(list->head, 0, list); \
+		type_t found = 0; \
+		for (chunk = list->head; chunk; chunk = (struct uchunk_t *) chunk->next) { \
+			data = get_uchunk_data(chunk, 0, list); \
+			if (reduction == LIST_SUM) { \
+				sum += sum_##name##_values((const type_t *) data, chunk->count); \
+			} else if (reduction == LIST_MIN) { \
+				found = min_##name##_values((const type_t *) data, chunk->count); \
+				best = found < best ? found : best; \
+			} else { \
+				found = max_##name##_values((const type_t *) data, chunk->count); \
+				best = found > best ? found : best; \
+			} \
+		} \
+		if (reduction == LIST_SUM) { \
+			memcpy(result, &sum, sizeof(sum)); \
+		} else { \
+			memcpy(result, &best, sizeof(best)); \
+		} \
+	} while (0)
+
+int reduce_uvalues(int reduction, int type, void *result, struct ulist_t *list)
+{
+	struct uchunk_t *chunk = NULL;
+	const void *data = NULL;
+
+	if (!list || !result) {
+		return 1;
+	}
+	if (reduction != LIST_SUM && reduction != LIST_MIN && reduction != LIST_MAX) {
+		return 3;
+	}
+	if (get_scan_typesize(type) != list->typesize) {
+		return 4;
+	}
+
+	/* The sum of no elements is zero */
+	if (!list->head) {
+		if (reduction != LIST_SUM) {
+			return 2;
+		}
+		switch (type) {
+		case LIST_INT32:
+			*(int64_t *) result = 0;
+			return 0;
+		case LIST_FLOAT:
+		case LIST_DOUBLE:
+			*(double *) result = 0;
+			return 0;
+		case LIST_UINT64:
+			*(uint64_t *) result = 0;
+			return 0;
+		default:
+			return 4;
+		}
+	}
+
+	switch (type) {
+	case LIST_INT32:
+		LIST_REDUCE_CHUNKS(int32, int32_t, int64_t);
+		return 0;
+	case LIST_FLOAT:
+		LIST_REDUCE_CHUNKS(float, float, double);
+		return 0;
+	case LIST_DOUBLE:
+		LIST_REDUCE_CHUNKS(double, double, double);
+		return 0;
+	case LIST_UINT64:
+		LIST_REDUCE_CHUNKS(uint64, uint64_t, uint64_t);
+		return 0;
+	default:
+		return 4;
+	}
+}
+
+/* LIST_IMPL */
+#endif
+
+/* SCAN_H */
+#endif
@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Scanning kernels for the C++ Wrapper of the Minimal C Linked List
+//   Usage and other information is provided in the README.md file from the
+//   repository. Please refer to that to know how to use this library.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SCAN_HPP
+#define SCAN_HPP "scan.hpp"
+
+// This header is just a wrapper for the scanning kernels
+#include "scan.h"
+#include "ulist.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace aplib
+{
+// The kernel of a type, only int32_t, float, double and uint64_t have
+// one. The sums are added in the sum type, which is the type itself for
+// the other types
+template<typename type_t>
+struct scan_kernel
+{
+	static constexpr bool vectorized = false;
+	using sum_t = type_t;
+};
+
+template<>
+struct scan_kernel<int32_t>
+{
+	static constexpr bool vectorized = true;
+	static constexpr int type = LIST_INT32;
+	using sum_t = int64_t;
+};
+
+template<>
+struct scan_kernel<float>
+{
+	static constexpr bool vectorized = true;
+	static constexpr int type = LIST_FLOAT;
+	using sum_t = double;
+};
+
+template<>
+struct scan_kernel<double>
+{
+	static constexpr bool vectorized = true;
+	static constexpr int type = LIST_DOUBLE;
+	using sum_t = double;
+};
+
+template<>
+struct scan_kernel<uint64_t>
+{
+	static constexpr bool vectorized = true;
+	static constexpr int type = LIST_UINT64;
+	using sum_t = uint64_t;
+};
+
+// Unrolled lists of the types with a kernel are scanned a chunk at a
+// time by it, every other list is scanned one element at a time
+template<typename type_t, typename alloc_t, typename backend_t>
+size_t find_value(const list<type_t, alloc_t, backend_t> &values,
+                  const type_t &value);
+template<typename type_t, typename alloc_t, typename backend_t>
+size_t count_values(const list<type_t, alloc_t, backend_t> &values,
+                    const type_t &value);
+template<typename type_t, typename alloc_t, typename backend_t>
+typename scan_kernel<type_t>::sum_t
+sum_values(const list<type_t, alloc_t, backend_t> &values);
+// These throw std::out_of_range if the list is empty
+template<typename type_t, typename alloc_t, typename backend_t>
+type_t min_value(const list<type_t, alloc_t, backend_t> &values);
+template<typename type_t, typename alloc_t, typename backend_t>
+type_t max_value(const list<type_t, alloc_t, backend_t> &values);
+
+// True if the list is scanned by the kernels
+template<typename type_t, typename backend_t>
+constexpr bool vectorized_scan = std::is_same<backend_t, unrolled>::value
+                                 && scan_kernel<type_t>::vectorized;
+}
+
+#ifdef LIST_IMPL
+
+template<typename type_t, typename alloc_t, typename backend_t>
+size_t aplib::find_value(const list<type_t, alloc_t, backend_t> &values,
+                         const type_t &value)
+{
+	size_t index = 0;
+
+	if constexpr (vectorized_scan<type_t, backend_t>) {
+		return find_uvalue(&value, scan_kernel<type_t>::type,
+		                   values.native_handle());
+	} else {
+		for (const type_t &compare : values) {
+			if (compare == value) {
+				return index;
+			}
+			index++;
+		}
+		return index;
+	}
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+size_t aplib::count_values(const list<type_t, alloc_t, backend_t> &values,
+                           const type_t &value)
+{
+	size_t count = 0;
+
+	if constexpr (vectorized_scan<type_t, backend_t>) {
+		return count_uvalues(&value, scan_kernel<type_t>::type,
+		                     values.native_handle());
+	} else {
+		for (const type_t &compare : values) {
+			count += compare == value ? 1 : 0;
+		}
+		return count;
+	}
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+typename aplib::scan_kernel<type_t>::sum_t
+aplib::sum_values(const list<type_t, alloc_t, backend_t> &values)
+{
+	typename scan_kernel<type_t>::sum_t sum {};
+
+	if constexpr (vectorized_scan<type_t, backend_t>) {
+		// A moved from list has no list to sum
+		if (values.native_handle()) {
+			reduce_uvalues(LIST_SUM, scan_kernel<type_t>::type, &sum,
+			               values.native_handle());
+		}
+	} else {
+		for (const type_t &value : values) {
+			sum = sum + value;
+		}
+	}
+	return sum;
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+type_t aplib::min_value(const list<type_t, alloc_t, backend_t> &values)
+{
+	if (values.size() == 0) {
+		throw std::out_of_range("aplib::min_value");
+	}
+
+	if constexpr (vectorized_scan<type_t, backend_t>) {
+		type_t result;
+		reduce_uvalues(LIST_MIN, scan_kernel<type_t>::type, &result,
+		               values.native_handle());
+		return result;
+	} else {
+		auto value = values.begin();
+		type_t result = *value;
+		for (++value; value != values.end(); ++value) {
+			if (*value < result) {
+				result = *value;
+			}
+		}
+		return result;
+	}
+}
+
+template<typename type_t, typename alloc_t, typename backend_t>
+type_t aplib::max_value(const list<type_t, alloc_t, backend_t> &values)
+{
+	if (values.size() == 0) {
+		throw std::out_of_range("aplib::max_value");
+	}
+
+	if constexpr (vectorized_scan<type_t, backend_t>) {
+		type_t result;
+		reduce_uvalues(LIST_MAX, scan_kernel<type_t>::type, &result,
+		               values.native_handle());
+		return result;
+	} else {
+		auto value = values.begin();
+		type_t result = *value;
+		for (++value; value != values.end(); ++value) {
+			if (result < *value) {
+				result = *value;
+			}
+		}
+		return result;
+	}
+}
+
+// LIST_IMPL
+#endif
+
+// SCAN_HPP
+#endif
@@ -0,0 +1,583 @@
+/*
+ * Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * A Minimal C Skip List
+ *   Usage and other information is provided in the README.md file from the
+ *   repository. Please refer to that to know how to use this library.
+ */
+
+#ifndef SKIPLIST_H
+#define SKIPLIST_H "skiplist.h"
+
+#include <string.h>
+
+/* The skip list uses the allocators of the list */
+#include "list.h"
+
+/* Implement the list code by defining
+ * LIST_IMPL before including this library */
+
+/* The maximum number of levels of a tower, enough for 4^32 elements */
+#ifndef SKIPLIST_LEVELS
+#define SKIPLIST_LEVELS 32
+#endif
+
+/* A link of a tower skips span elements */
+struct slink_t {
+	void *next;
+	size_t span;
+};
+
+/* The data and the next of an element are the same as of the elements of
+ * the list, walking the next goes through every element in order. The
+ * next and the span are the link of the level 0. The tower holds the links
+ * of the levels above, it is allocated along with the element and the data */
+struct selement_t {
+	void *data;
+	void *next;
+	size_t span;
+	size_t level;
+	struct slink_t *tower;
+};
+
+struct skiplist_t {
+	/* The base does not contain an element, its tower is of every level */
+	struct selement_t *base;
+	size_t size;
+	size_t typesize;
+	/* The number of levels in use */
+	size_t level;
+	/* Ordered lists keep the elements sorted using compare */
+	int (*compare)(const void *, const void *);
+	/* The state of the random levels of the towers */
+	unsigned long long seed;
+	/* Elements are allocated using malloc if there is no allocate */
+	struct list_allocator_t allocator;
+};
+
+
+struct skiplist_t *create_skiplist(size_t typesize);
+/* The compare function is like the one of qsort */
+struct skiplist_t *create_ordered_skiplist(size_t typesize,
+                                           int (*compare)(const void *, const void *));
+/* The allocator is copied into the list, the elements are allocated using
+ * malloc if the allocator is NULL. The list is not ordered if compare is NULL */
+struct skiplist_t *create_skiplist_with_allocator(size_t typesize,
+                                                  int (*compare)(const void *, const void *),
+                                                  const struct list_allocator_t *allocator);
+
+/* Finding an index skips over elements using the towers. The base is
+ * given for the index of -1 */
+struct selement_t *get_selement(size_t index, struct skiplist_t *list);
+size_t get_skiplist_size(struct skiplist_t *list);
+
+/* Define LIST_DEBUG to check the size, the
+ * towers and the spans of a list */
+#ifdef LIST_DEBUG
+int skiplist_verify(struct skiplist_t *list);
+#endif
+
+/* These functions are not supposed to be used externally */
+struct selement_t *create_selement(size_t level, struct skiplist_t *list);
+int delete_selement(struct selement_t *element, struct skiplist_t *list);
+size_t random_skiplist_level(struct skiplist_t *list);
+void **get_snext(struct selement_t *element, size_t level);
+size_t *get_sspan(struct selement_t *element, size_t level);
+
+/* You can add element at the end of the list by giving it the size of the
+ * list. Adding at an index does not keep an ordered list in order */
+struct selement_t *add_selement(size_t index, struct skiplist_t *list);
+int remove_selement(size_t index, struct skiplist_t *list);
+
+/* These functions are for ordered lists. The data is copied into the
+ * element, which is added after the elements equal to it */
+struct selement_t *insert_selement(const void *data, struct skiplist_t *list);
+/* The first element equal to the key, NULL if there is none */
+struct selement_t *find_selement(const void *key, struct skiplist_t *list);
+/* The first element not less than, and the first element greater than
+ * the key. Walk the next from one to the other for a range of elements */
+struct selement_t *lower_bound_selement(const void *key, struct skiplist_t *list);
+struct selement_t *upper_bound_selement(const void *key, struct skiplist_t *list);
+/* The number of elements less than the key (or not greater if upper),
+ * which is the index of the lower bound (or the upper bound) */
+size_t get_skiplist_rank(const void *key, int upper, struct skiplist_t *list);
+
+int clear_skiplist(struct skiplist_t *list);
+int delete_skiplist(struct skiplist_t *list);
+
+#ifdef LIST_IMPL
+
+struct skiplist_t *create_skiplist(size_t typesize)
+{
+	return create_skiplist_with_allocator(typesize, NULL, NULL);
+}
+
+struct skiplist_t *create_ordered_skiplist(size_t typesize,
+                                           int (*compare)(const void *, const void *))
+{
+	return create_skiplist_with_allocator(typesize, compare, NULL);
+}
+
+struct skiplist_t *create_skiplist_with_allocator(size_t typesize,
+                                                  int (*compare)(const void *, const void *),
+                                                  const struct list_allocator_t *allocator)
+{
+	struct skiplist_t *list = (struct skiplist_t *) malloc(sizeof(struct skiplist_t));
+
+	if (!list) {
+		return NULL;
+	}
+
+	list->size = 0;
+	list->typesize = typesize;
+	list->level = 1;
+	list->compare = compare;
+	list->seed = 0x9e3779b97f4a7c15ull;
+	list->allocator.allocate = NULL;
+	list->allocator.deallocate = NULL;
+	list->allocator.release = NULL;
+	list->allocator.context = NULL;
+	if (allocator) {
+		list->allocator = *allocator;
+	}
+
+	/* The base is allocated with the allocator, it has no data */
+	list->typesize = 0;
+	list->base = create_selement(SKIPLIST_LEVELS, list);
+	list->typesize = typesize;
+	if (!list->base) {
+		free(list);
+		return NULL;
+	}
+	return list;
+}
+
+struct selement_t *get_selement(size_t index, struct skiplist_t *list)
+{
+	struct selement_t *element = NULL;
+	size_t position = 0;
+
+	if (!list) {
+		return NULL;
+	}
+	if (!list->base) {
+		return NULL;
+	}
+
+	/* The base is at the position 0, the element at the index is after it */
+	index++;
+	if (index > list->size) {
+		return NULL;
+	}
+
+	element = list->base;
+	for (size_t level = list->level; level-- > 0;) {
+		while (*get_snext(element, level)
+		       && position + *get_sspan(element, level) <= index) {
+			position += *get_sspan(element, level);
+			element = (struct selement_t *) *get_snext(element, level);
+		}
+		if (position == index) {
+			return element;
+		}
+	}
+	return element;
+}
+
+size_t get_skiplist_size(struct skiplist_t *list)
+{
+	if (!list) {
+		return 0;
+	}
+	return list->size;
+}
+
+#ifdef LIST_DEBUG
+int skiplist_verify(struct skiplist_t *list)
+{
+	struct selement_t *element = NULL;
+	struct selement_t *next = NULL;
+	size_t size = 0;
+
+	if (!list) {
+		return 1;
+	}
+	if (!list->base) {
+		return 2;
+	}
+
+	/* Stop after the size is exceeded, in case the links have a loop */
+	element = (struct selement_t *) list->base->next;
+	while (element && size <= list->size) {
+		if (!element->data) {
+			return 3;
+		}
+		if (element->level == 0 || element->level > list->level) {
+			return 4;
+		}
+		next = (struct selement_t *) element->next;
+		if (list->compare && next && list->compare(element->data, next->data) > 0) {
+			return 5;
+		}
+		element = next;
+		size++;
+	}
+	if (size != list->size) {
+		return 6;
+	}
+
+	/* Every link of every level skips over span elements */
+	for (size_t level = 1; level < list->level; level++) {
+		element = list->base;
+		while (*get_snext(element, level)) {
+			next = element;
+			for (size_t i = 0; i < *get_sspan(element, level) && next; i++) {
+				next = (struct selement_t *) next->next;
+			}
+			if (next != *get_snext(element, level) || next->level <= level) {
+				return 7;
+			}
+			element = next;
+		}
+	}
+	return 0;
+}
+#endif
+
+
+
+struct selement_t *create_selement(size_t level, struct skiplist_t *list)
+{
+	struct selement_t *element = NULL;
+	size_t offset = 0;
+
+	if (!list) {
+		return NULL;
+	}
+
+	/* The links of the tower come after the element, then the data */
+	offset = align_data_offset(sizeof(struct selement_t)
+	                           + (level - 1) * sizeof(struct slink_t), list->typesize);
+	if (list->allocator.allocate) {
+		element = (struct selement_t *) list->allocator.allocate(
+		                  list->allocator.context, offset + list->typesize);
+	} else {
+		element = (struct selement_t *) malloc(offset + list->typesize);
+	}
+	if (!element) {
+		return NULL;
+	}
+
+	element->next = NULL;
+	element->span = 0;
+	element->level = level;
+	element->tower = (struct slink_t *) (element + 1);
+	for (size_t i = 0; i + 1 < level; i++) {
+		element->tower[i].next = NULL;
+		element->tower[i].span = 0;
+	}
+	element->data = (void *) ((char *) element + offset);
+	return element;
+}
+
+int delete_selement(struct selement_t *element, struct skiplist_t *list)
+{
+	size_t typesize = 0;
+
+	if (!list) {
+		return 1;
+	}
+	if (!element) {
+		return 1;
+	}
+
+	/* The base was allocated without data */
+	typesize = element == list->base ? 0 : list->typesize;
+	if (list->allocator.deallocate) {
+		list->allocator.deallocate(list->allocator.context, element,
+		                           align_data_offset(sizeof(struct selement_t)
+		                                             + (element->level - 1)
+		                                             * sizeof(struct slink_t),
+		                                             typesize) + typesize);
+	} else {
+		free(element);
+	}
+	return 0;
+}
+
+size_t random_skiplist_level(struct skiplist_t *list)
+{
+	size_t level = 1;
+	unsigned long long bits = 0;
+
+	/* xorshift64*, a tower goes up a level with the probability of 1/4 */
+	list->seed ^= list->seed >> 12;
+	list->seed ^= list->seed << 25;
+	list->seed ^= list->seed >> 27;
+	bits = list->seed * 0x2545f4914f6cdd1dull;
+	while (level < SKIPLIST_LEVELS && (bits & 3) == 0) {
+		bits >>= 2;
+		level++;
+	}
+	return level;
+}
+
+void **get_snext(struct selement_t *element, size_t level)
+{
+	return level ? &element->tower[level - 1].next : &element->next;
+}
+
+size_t *get_sspan(struct selement_t *element, size_t level)
+{
+	return level ? &element->tower[level - 1].span : &element->span;
+}
+
+struct selement_t *add_selement(size_t index, struct skiplist_t *list)
+{
+	struct selement_t *update[SKIPLIST_LEVELS];
+	size_t positions[SKIPLIST_LEVELS];
+	struct selement_t *element = NULL;
+	struct selement_t *new_element = NULL;
+	size_t position = 0;
+	size_t level = 0;
+
+	if (!list) {
+		return NULL;
+	}
+	if (!list->base) {
+		return NULL;
+	}
+	if (index > list->size) {
+		return NULL;
+	}
+
+	/* Find the last element before the index on every level */
+	element = list->base;
+	for (size_t i = list->level; i-- > 0;) {
+		while (*get_snext(element, i) && position + *get_sspan(element, i) <= index) {
+			position += *get_sspan(element, i);
+			element = (struct selement_t *) *get_snext(element, i);
+		}
+		update[i] = element;
+		positions[i] = position;
+	}
+
+	level = random_skiplist_level(list);
+	new_element = create_selement(level, list);
+	if (!new_element) {
+		return NULL;
+	}
+	for (size_t i = list->level; i < level; i++) {
+		update[i] = list->base;
+		positions[i] = 0;
+	}
+	if (level > list->level) {
+		list->level = level;
+	}
+
+	/* The new element is at the position index + 1, the spans of
+	 * the links it splits are shared with the new element */
+	for (size_t i = 0; i < list->level; i++) {
+		if (i >= level) {
+			if (*get_snext(update[i], i)) {
+				(*get_sspan(update[i], i))++;
+			}
+			continue;
+		}
+		*get_snext(new_element, i) = *get_snext(update[i], i);
+		*get_sspan(new_element, i) = *get_snext(update[i], i)
+		                             ? *get_sspan(update[i], i) - (index - positions[i]) : 0;
+		*get_snext(update[i], i) = new_element;
+		*get_sspan(update[i], i) = index - positions[i] + 1;
+	}
+
+	list->size++;
+	return new_element;
+}
+
+int remove_selement(size_t index, struct skiplist_t *list)
+{
+	struct selement_t *update[SKIPLIST_LEVELS];
+	struct selement_t *element = NULL;
+	size_t position = 0;
+
+	if (!list) {
+		return 1;
+	}
+	if (!list->base) {
+		return 3;
+	}
+	if (index >= list->size) {
+		return 4;
+	}
+
+	/* Find the last element before the index on every level */
+	element = list->base;
+	for (size_t i = list->level; i-- > 0;) {
+		while (*get_snext(element, i) && position + *get_sspan(element, i) <= index) {
+			position += *get_sspan(element, i);
+			element = (struct selement_t *) *get_snext(element, i);
+		}
+		update[i] = element;
+	}
+
+	/* The links to the element skip over it instead, the
+	 * element found on the level 0 is the one before it */
+	element = (struct selement_t *) element->next;
+	for (size_t i = 0; i < list->level; i++) {
+		if (*get_snext(update[i], i) == (void *) element) {
+			*get_snext(update[i], i) = *get_snext(element, i);
+			*get_sspan(update[i], i) = *get_snext(element, i)
+			                           ? *get_sspan(update[i], i) + *get_sspan(element, i) - 1 : 0;
+		} else if (*get_snext(update[i], i)) {
+			(*get_sspan(update[i], i))--;
+		}
+	}
+	while (list->level > 1 && !*get_snext(list->base, list->level - 1)) {
+		list->level--;
+	}
+
+	delete_selement(element, list);
+	list->size--;
+	return 0;
+}
+
+struct selement_t *insert_selement(const void *data, struct skiplist_t *list)
+{
+	struct selement_t *element = NULL;
+
+	if (!list || !list->compare) {
+		return NULL;
+	}
+
+	element = add_selement(get_skiplist_rank(data, 1, list), list);
+	if (element && data) {
+		memcpy(element->data, data, list->typesize);
+	}
+	return element;
+}
+
+struct selement_t *find_selement(const void *key, struct skiplist_t *list)
+{
+	struct selement_t *element = lower_bound_selement(key, list);
+
+	if (element && list->compare(element->data, key) == 0) {
+		return element;
+	}
+	return NULL;
+}
+
+struct selement_t *lower_bound_selement(const void *key, struct skiplist_t *list)
+{
+	size_t rank = get_skiplist_rank(key, 0, list);
+
+	if (!list || !list->compare || rank >= list->size) {
+		return NULL;
+	}
+	return get_selement(rank, list);
+}
+
+struct selement_t *upper_bound_selement(const void *key, struct skiplist_t *list)
+{
+	size_t rank = get_skiplist_rank(key, 1, list);
+
+	if (!list || !list->compare || rank >= list->size) {
+		return NULL;
+	}
+	return get_selement(rank, list);
+}
+
+size_t get_skiplist_rank(const void *key, int upper, struct skiplist_t *list)
+{
+	struct selement_t *element = NULL;
+	size_t position = 0;
+	int compared = 0;
+
+	if (!list || !list->compare || !list->base) {
+		return 0;
+	}
+
+	/* Skip over the elements less than (or not greater than) the key */
+	element = list->base;
+	for (size_t i = list->level; i-- > 0;) {
+		while (*get_snext(element, i)) {
+			compared = list->compare(((struct selement_t *) *get_snext(element, i))->data,
+			                         key);
+			if (compared > 0 || (compared == 0 && !upper)) {
+				break;
+			}
+			position += *get_sspan(element, i);
+			element = (struct selement_t *) *get_snext(element, i);
+		}
+	}
+	return position;
+}
+
+int clear_skiplist(struct skiplist_t *list)
+{
+	struct selement_t *element = NULL;
+	struct selement_t *next = NULL;
+
+	if (!list) {
+		return 1;
+	}
+	if (!list->base) {
+		return 3;
+	}
+
+	/* Every element is linked on the level 0 */
+	element = (struct selement_t *) list->base->next;
+	while (element) {
+		next = (struct selement_t *) element->next;
+		delete_selement(element, list);
+		element = next;
+	}
+	for (size_t i = 0; i < SKIPLIST_LEVELS; i++) {
+		*get_snext(list->base, i) = NULL;
+		*get_sspan(list->base, i) = 0;
+	}
+	list->level = 1;
+	list->size = 0;
+	return 0;
+}
+
+int delete_skiplist(struct skiplist_t *list)
+{
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+
+	error = clear_skiplist(list);
+	if (error) {
+		return error;
+	}
+	delete_selement(list->base, list);
+	free(list);
+	return 0;
+}
+
+/* LIST_IMPL */
+#endif
+
+/* SKIPLIST_H */
+#endif
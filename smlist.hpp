@@ -0,0 +1,494 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Small list for the C++ Wrapper of the Minimal C Linked List
+//   Usage and other information is provided in the README.md file from the
+//   repository. Please refer to that to know how to use this library.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SMLIST_HPP
+#define SMLIST_HPP "smlist.hpp"
+
+#include "list.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace aplib
+{
+// A singly linked list keeping its list, its base and the first size
+// elements inside the object, so that a list of at most size elements
+// does not allocate at all. The elements after them are allocated using
+// malloc, and the removed elements inside the object are used again.
+// Moving and swapping move the values one by one, like a small vector
+template<typename type_t, size_t size_v = 8>
+class small_list
+{
+	static_assert(size_v > 0, "A small list keeps at least one element inside");
+public:
+	// The iterators are the ones of a list, both walk the same elements
+	using iterator = typename list<type_t>::iterator;
+	using const_iterator = typename list<type_t>::const_iterator;
+	static constexpr size_t inline_size = size_v;
+private:
+	// The offset of the data after the element, as get_data_offset does,
+	// and the size of an element kept inside aligned for the next one
+	static constexpr size_t get_data_offset();
+	static constexpr size_t slot_size = (get_data_offset() + sizeof(type_t)
+	                                     + alignof(std::max_align_t) - 1)
+	                                    & ~(alignof(std::max_align_t) - 1);
+
+	list_t internal_list;
+	alignas(std::max_align_t) unsigned char slots[size_v * slot_size];
+	// Removed slots are linked through their first bytes, the slots
+	// from unused to the end have not been handed out yet
+	void *free_slots;
+	size_t unused;
+
+	static void *allocate_element(void *context, size_t size);
+	static void deallocate_element(void *context, void *pointer, size_t size);
+	void create_internal_list();
+public:
+	small_list();
+	small_list(const small_list &other);
+	small_list(small_list &&other);
+	~small_list();
+
+	small_list &operator=(const small_list &other);
+	small_list &operator=(small_list &&other);
+	void swap(small_list &other);
+
+	template<typename... args_t>
+	type_t &emplace(size_t index, args_t &&... args);
+	template<typename... args_t>
+	type_t &emplace_front(args_t &&... args);
+	template<typename... args_t>
+	type_t &emplace_back(args_t &&... args);
+
+	small_list &insert(size_t index, const type_t &value);
+	small_list &insert(size_t index, type_t &&value);
+	small_list &erase(size_t index);
+
+	size_t size() const;
+	// Throws std::out_of_range if the index is past the last element
+	type_t &at(size_t index);
+	type_t &operator[](size_t index);
+	type_t &front();
+	type_t &back();
+	small_list &clear();
+
+	small_list &push_back(const type_t &value);
+	small_list &push_back(type_t &&value);
+	small_list &pop_back();
+	small_list &push_front(const type_t &value);
+	small_list &push_front(type_t &&value);
+	small_list &pop_front();
+
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+	const_iterator cbegin() const;
+	const_iterator cend() const;
+	iterator nth(size_t index);
+	const_iterator nth(size_t index) const;
+
+	// The list inside the object, it moves along with the object
+	using native_handle_type = list_t *;
+	native_handle_type native_handle();
+};
+}
+
+#ifdef LIST_IMPL
+
+template<typename type_t, size_t size_v>
+constexpr size_t aplib::small_list<type_t, size_v>::get_data_offset()
+{
+	size_t align = sizeof(type_t) & (~sizeof(type_t) + 1);
+
+	if (!align || align > LIST_MAX_ALIGN) {
+		align = LIST_MAX_ALIGN;
+	}
+	return (sizeof(element_t) + align - 1) & ~(align - 1);
+}
+
+template<typename type_t, size_t size_v>
+void *aplib::small_list<type_t, size_v>::allocate_element(void *context, size_t size)
+{
+	small_list &values = *(small_list *) context;
+	void *slot = values.free_slots;
+
+	if (size > slot_size) {
+		return std::malloc(size);
+	}
+	if (slot) {
+		values.free_slots = *(void **) slot;
+		return slot;
+	}
+	if (values.unused < size_v) {
+		return (void *) (values.slots + slot_size * values.unused++);
+	}
+	return std::malloc(size);
+}
+
+template<typename type_t, size_t size_v>
+void aplib::small_list<type_t, size_v>::deallocate_element(void *context, void *pointer,
+        size_t size)
+{
+	small_list &values = *(small_list *) context;
+	unsigned char *slot = (unsigned char *) pointer;
+
+	(void) size;
+	if (slot < values.slots || slot >= values.slots + sizeof(values.slots)) {
+		std::free(pointer);
+		return;
+	}
+	*(void **) slot = values.free_slots;
+	values.free_slots = (void *) slot;
+}
+
+template<typename type_t, size_t size_v>
+void aplib::small_list<type_t, size_v>::create_internal_list()
+{
+	list_allocator_t internal_allocator;
+	internal_allocator.allocate = allocate_element;
+	internal_allocator.deallocate = deallocate_element;
+	internal_allocator.release = nullptr;
+	internal_allocator.context = (void *) this;
+
+	// The list and its base are in the object, nothing is allocated
+	list_init(sizeof(type_t), &internal_allocator, &internal_list);
+	free_slots = nullptr;
+	unused = 0;
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v>::small_list()
+{
+	create_internal_list();
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v>::small_list(const small_list &other)
+{
+	create_internal_list();
+
+	// The destructor is not called if the constructor throws
+	try {
+		for (const type_t &value : other) {
+			emplace_back(value);
+		}
+	} catch (...) {
+		clear();
+		throw;
+	}
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v>::small_list(small_list &&other)
+{
+	create_internal_list();
+
+	// The elements inside the other object cannot be taken
+	try {
+		for (type_t &value : other) {
+			emplace_back(std::move(value));
+		}
+	} catch (...) {
+		clear();
+		throw;
+	}
+	other.clear();
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v>::~small_list()
+{
+	clear();
+	list_destroy(&internal_list);
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::operator=(const
+        small_list &other)
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	clear();
+	for (const type_t &value : other) {
+		emplace_back(value);
+	}
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::operator=(
+        small_list &&other)
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	clear();
+	for (type_t &value : other) {
+		emplace_back(std::move(value));
+	}
+	other.clear();
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+void aplib::small_list<type_t, size_v>::swap(small_list &other)
+{
+	small_list values(std::move(other));
+
+	other = std::move(*this);
+	*this = std::move(values);
+}
+
+template<typename type_t, size_t size_v>
+template<typename... args_t>
+type_t &aplib::small_list<type_t, size_v>::emplace(size_t index, args_t &&... args)
+{
+	element_t *element = nullptr;
+
+	if (index > size()) {
+		throw std::out_of_range("aplib::small_list::emplace");
+	}
+	element = add_element(index, &internal_list);
+	if (!element) {
+		throw std::bad_alloc();
+	}
+
+	// Remove the element again if the value could not be constructed
+	try {
+		return *new (element->data) type_t(std::forward<args_t>(args)...);
+	} catch (...) {
+		remove_element(index, &internal_list);
+		throw;
+	}
+}
+
+template<typename type_t, size_t size_v>
+template<typename... args_t>
+type_t &aplib::small_list<type_t, size_v>::emplace_front(args_t &&... args)
+{
+	return emplace(0, std::forward<args_t>(args)...);
+}
+
+template<typename type_t, size_t size_v>
+template<typename... args_t>
+type_t &aplib::small_list<type_t, size_v>::emplace_back(args_t &&... args)
+{
+	return emplace(size(), std::forward<args_t>(args)...);
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::insert(size_t index,
+        const type_t &value)
+{
+	emplace(index, value);
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::insert(size_t index,
+        type_t &&value)
+{
+	emplace(index, std::move(value));
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::erase(size_t index)
+{
+	element_t *element = index < size() ? get_element(index, &internal_list) : nullptr;
+
+	if (!element) {
+		return *this;
+	}
+	((type_t *) element->data)->~type_t();
+	remove_element(index, &internal_list);
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+size_t aplib::small_list<type_t, size_v>::size() const
+{
+	return internal_list.size;
+}
+
+template<typename type_t, size_t size_v>
+type_t &aplib::small_list<type_t, size_v>::at(size_t index)
+{
+	if (index >= size()) {
+		throw std::out_of_range("aplib::small_list::at");
+	}
+	return *(type_t *) get_element(index, &internal_list)->data;
+}
+
+template<typename type_t, size_t size_v>
+type_t &aplib::small_list<type_t, size_v>::operator[](size_t index)
+{
+	return *(type_t *) get_element(index, &internal_list)->data;
+}
+
+template<typename type_t, size_t size_v>
+type_t &aplib::small_list<type_t, size_v>::front()
+{
+	return *begin();
+}
+
+template<typename type_t, size_t size_v>
+type_t &aplib::small_list<type_t, size_v>::back()
+{
+	return *(type_t *) internal_list.tail->data;
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::clear()
+{
+	if (!std::is_trivially_destructible<type_t>::value) {
+		for (type_t &value : *this) {
+			value.~type_t();
+		}
+	}
+	clear_list(&internal_list);
+
+	// Every slot is free again, they are handed out in order
+	free_slots = nullptr;
+	unused = 0;
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::push_back(const
+        type_t &value)
+{
+	emplace_back(value);
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::push_back(type_t &&value)
+{
+	emplace_back(std::move(value));
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::pop_back()
+{
+	if (size() > 0) {
+		erase(size() - 1);
+	}
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::push_front(const
+        type_t &value)
+{
+	emplace_front(value);
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::push_front(type_t &&value)
+{
+	emplace_front(std::move(value));
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+aplib::small_list<type_t, size_v> &aplib::small_list<type_t, size_v>::pop_front()
+{
+	if (size() > 0) {
+		erase(0);
+	}
+	return *this;
+}
+
+template<typename type_t, size_t size_v>
+typename aplib::small_list<type_t, size_v>::iterator aplib::small_list<type_t, size_v>::begin()
+{
+	return iterator((element_t *) internal_list.base->next);
+}
+
+template<typename type_t, size_t size_v>
+typename aplib::small_list<type_t, size_v>::iterator aplib::small_list<type_t, size_v>::end()
+{
+	return iterator(singly_linked::end(&internal_list));
+}
+
+template<typename type_t, size_t size_v>
+typename aplib::small_list<type_t, size_v>::const_iterator aplib::small_list<type_t, size_v>::begin() const
+{
+	return cbegin();
+}
+
+template<typename type_t, size_t size_v>
+typename aplib::small_list<type_t, size_v>::const_iterator aplib::small_list<type_t, size_v>::end() const
+{
+	return cend();
+}
+
+template<typename type_t, size_t size_v>
+typename aplib::small_list<type_t, size_v>::const_iterator aplib::small_list<type_t, size_v>::cbegin() const
+{
+	return const_iterator((element_t *) internal_list.base->next);
+}
+
+template<typename type_t, size_t size_v>
+typename aplib::small_list<type_t, size_v>::const_iterator aplib::small_list<type_t, size_v>::cend() const
+{
+	return const_iterator(singly_linked::end((list_t *) &internal_list));
+}
+
+template<typename type_t, size_t size_v>
+typename aplib::small_list<type_t, size_v>::iterator aplib::small_list<type_t, size_v>::nth(size_t index)
+{
+	return iterator(singly_linked::find(index, &internal_list));
+}
+
+template<typename type_t, size_t size_v>
+typename aplib::small_list<type_t, size_v>::const_iterator aplib::small_list<type_t, size_v>::nth(size_t index) const
+{
+	return const_iterator(singly_linked::find(index, (list_t *) &internal_list));
+}
+
+template<typename type_t, size_t size_v>
+typename aplib::small_list<type_t, size_v>::native_handle_type aplib::small_list<type_t, size_v>::native_handle()
+{
+	return &internal_list;
+}
+
+// LIST_IMPL
+#endif
+
+// SMLIST_HPP
+#endif
@@ -23,8 +23,51 @@
  */
 
 #include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
 #define LIST_IMPL
 #include "list.h"
+#include "dlist.h"
+#include "ulist.h"
+#include "lflist.h"
+#include "lqueue.h"
+#include "skiplist.h"
+#include "tlist.h"
+#include "mlist.h"
+#include "listio.h"
+#include "scan.h"
+#include "typedlist.h"
+#include "ilist.h"
+
+/* A list of doubles with its functions named double_list_... */
+LIST_DECLARE(double_list, double)
+LIST_DEFINE(double_list, double)
+
+/* Ordered skip lists compare their elements like qsort */
+static int compare_ints(const void *a, const void *b)
+{
+	int first = *(const int *) a;
+	int second = *(const int *) b;
+
+	return (first > second) - (first < second);
+}
+
+/* Packets link themselves into an intrusive list, it allocates nothing */
+struct packet_t {
+	int length;
+	struct element_t link;
+};
+
+/* Indexed lists find the key in the data, here it is the first int */
+static const void *get_int_key(const void *data)
+{
+	return data;
+}
+
+static size_t hash_int(const void *key)
+{
+	return (size_t) *(const int *) key;
+}
 
 int main(void)
 {
@@ -114,6 +157,30 @@ int main(void)
 		return 6;
 	}
 
+	/* Print the size of the list again */
+	printf("Number of elements in list: %lu\n",
+	       get_list_size(my_list));
+
+	/* Adding at the end and accessing elements in
+	 * order does not walk the list from the beginning */
+	for (int i = 0; i < 1000; i++) {
+		element = add_element(get_list_size(my_list), my_list);
+		if (!element) {
+			return 8;
+		}
+		*(int *) element->data = i;
+	}
+	for (size_t i = 0; i < get_list_size(my_list); i++) {
+		if (*(int *) get_element(i, my_list)->data != (int) i) {
+			return 9;
+		}
+	}
+
+	/* Check the list for consistency, only with LIST_DEBUG */
+	if (list_verify(my_list)) {
+		return 10;
+	}
+
 	/* Print the size of the list again */
 	printf("Number of elements in list: %lu\n",
 	       get_list_size(my_list));
@@ -123,6 +190,513 @@ int main(void)
 		/* Failed to delete a list... */
 		return 7;
 	}
+
+	/* Create a pool that allocates elements 256 at a time */
+	struct list_pool_t *pool = create_list_pool(sizeof (int), 256);
+	if (!pool) {
+		return 11;
+	}
+
+	/* Create a list that allocates elements from the pool */
+	struct list_allocator_t allocator = get_list_pool_allocator(pool);
+	my_list = create_list_with_allocator(sizeof (int), &allocator);
+	if (!my_list) {
+		return 12;
+	}
+
+	/* Use the list like any other list */
+	for (int i = 0; i < 1000; i++) {
+		*(int *) add_element(get_list_size(my_list), my_list)->data = i;
+	}
+	remove_element(0, my_list);
+	*(int *) add_element(0, my_list)->data = 0;
+	if (list_verify(my_list)) {
+		return 13;
+	}
+
+	/* Print the size of the list again */
+	printf("Number of elements in pooled list: %lu\n",
+	       get_list_size(my_list));
+
+	/* Clearing the list frees the chunks of the pool at once */
+	clear_list(my_list);
+
+	/* Delete the pool after the list */
+	delete_list(my_list);
+	delete_list_pool(pool);
+
+	/* Create a doubly linked list */
+	struct dlist_t *my_dlist = create_dlist(sizeof (int));
+	if (!my_dlist) {
+		return 14;
+	}
+
+	/* Adding and removing at either end does not walk the list */
+	*(int *) add_delement(0, my_dlist)->data = 20;
+	*(int *) add_delement(0, my_dlist)->data = 10;
+	*(int *) add_delement(get_dlist_size(my_dlist), my_dlist)->data = 30;
+	*(int *) add_delement(get_dlist_size(my_dlist), my_dlist)->data = 40;
+	remove_delement(get_dlist_size(my_dlist) - 1, my_dlist);
+
+	/* Adding before an element and removing an element do not walk either */
+	struct delement_t *delement = get_delement(1, my_dlist);
+	*(int *) insert_delement(delement, my_dlist)->data = 15;
+	erase_delement(delement, my_dlist);
+	if (dlist_verify(my_dlist)) {
+		return 15;
+	}
+
+	/* Print all the elements from the end of the list to its beginning */
+	for (delement = my_dlist->base->prev; delement != my_dlist->base;
+	     delement = delement->prev) {
+		printf("Element: %i\n", *(int *) delement->data);
+	}
+
+	if (delete_dlist(my_dlist)) {
+		return 16;
+	}
+
+	/* Create an unrolled list, elements are stored next to each other */
+	struct ulist_t *my_ulist = create_ulist(sizeof (int));
+	if (!my_ulist) {
+		return 17;
+	}
+
+	/* Its functions give the data of the elements directly */
+	for (int i = 0; i < 1000; i++) {
+		*(int *) add_uelement(get_ulist_size(my_ulist), my_ulist) = i;
+	}
+	for (int i = 0; i < 500; i++) {
+		remove_uelement(i, my_ulist);
+	}
+	if (ulist_verify(my_ulist)) {
+		return 18;
+	}
+
+	/* Going through the chunks visits the elements in order */
+	long sum = 0;
+	for (struct uchunk_t *chunk = my_ulist->head; chunk;
+	     chunk = (struct uchunk_t *) chunk->next) {
+		int *data = (int *) get_uchunk_data(chunk, 0, my_ulist);
+		for (size_t i = 0; i < chunk->count; i++) {
+			sum += data[i];
+		}
+	}
+	printf("Sum of elements in unrolled list: %li\n", sum);
+
+	if (delete_ulist(my_ulist)) {
+		return 19;
+	}
+
+	/* Chunks holding one element are made to hold two, so they split */
+	struct ulist_t *tiny_ulist = create_ulist_with_allocator(sizeof (int), 1, NULL);
+	if (!tiny_ulist) {
+		return 19;
+	}
+	for (int i = 0; i < 64; i++) {
+		*(int *) add_uelement(i / 3, tiny_ulist) = i;
+	}
+	if (ulist_verify(tiny_ulist) || *(int *) get_uelement(21, tiny_ulist) != 63
+	    || delete_ulist(tiny_ulist)) {
+		return 19;
+	}
+
+	/* Create a lock-free list, many threads can use it at the same time */
+	struct lflist_t *my_lflist = create_lflist(sizeof (int));
+	if (!my_lflist) {
+		return 20;
+	}
+
+	/* Each thread joins the list, and enters it before using its elements */
+	struct lfthread_t *thread = join_lflist(my_lflist);
+	if (!thread) {
+		return 21;
+	}
+	enter_lflist(thread);
+	for (int i = 0; i < 100; i++) {
+		insert_lfelement(my_lflist->base, &i, thread);
+	}
+	struct lfelement_t *lfelement = first_lfelement(thread);
+	while (lfelement) {
+		struct lfelement_t *next = next_lfelement(lfelement, thread);
+		if (*(int *) lfelement->data % 2 && remove_lfelement(lfelement, thread)) {
+			return 22;
+		}
+		lfelement = next;
+	}
+	exit_lflist(thread);
+	printf("Number of elements in lock-free list: %zu\n", get_lflist_size(my_lflist));
+
+	leave_lflist(thread);
+	if (delete_lflist(my_lflist)) {
+		return 23;
+	}
+
+	/* Create a queue of 16 elements that many threads can use at the same time */
+	struct lqueue_t *my_queue = create_lqueue(sizeof (int), 16, LQUEUE_MPMC);
+	if (!my_queue) {
+		return 24;
+	}
+
+	/* A full queue does not take more elements */
+	int values[20] = {0};
+	for (int i = 0; i < 20; i++) {
+		values[i] = i + 1;
+	}
+	size_t enqueued = enqueue_lqueue_batch(my_queue, values, 20);
+	int value = 0;
+	dequeue_lqueue(my_queue, &value);
+	printf("Enqueued %zu elements, the first one is %i\n", enqueued, value);
+
+	if (delete_lqueue(my_queue)) {
+		return 25;
+	}
+
+	/* Create an ordered skip list, finding an element does not walk the list */
+	struct skiplist_t *my_skiplist = create_ordered_skiplist(sizeof (int), compare_ints);
+	if (!my_skiplist) {
+		return 26;
+	}
+	for (int i = 0; i < 1000; i++) {
+		int key = (i * 7919) % 1000;
+		insert_selement(&key, my_skiplist);
+	}
+	remove_selement(0, my_skiplist);
+	if (skiplist_verify(my_skiplist)) {
+		return 27;
+	}
+
+	/* Elements are in order, walk the next for a range of them */
+	int low = 500;
+	int high = 503;
+	printf("Elements from 500 to 503:");
+	for (struct selement_t *selement = lower_bound_selement(&low, my_skiplist);
+	     selement && *(int *) selement->data <= high;
+	     selement = (struct selement_t *) selement->next) {
+		printf(" %i", *(int *) selement->data);
+	}
+	printf(", element #10: %i\n", *(int *) get_selement(10, my_skiplist)->data);
+
+	if (delete_skiplist(my_skiplist)) {
+		return 28;
+	}
+
+	/* Create a tree list, elements are in leaves of a tree counting them */
+	struct tlist_t *my_tlist = create_tlist(sizeof (int));
+	if (!my_tlist) {
+		return 29;
+	}
+
+	/* Adding, removing and getting at an index go down the tree */
+	for (int i = 0; i < 1000; i++) {
+		*(int *) add_telement(i / 2, my_tlist) = i;
+	}
+	for (int i = 0; i < 500; i++) {
+		remove_telement(i, my_tlist);
+	}
+	if (tlist_verify(my_tlist)) {
+		return 30;
+	}
+	printf("Element #0: %i, element #499: %i\n", *(int *) get_telement(0, my_tlist),
+	       *(int *) get_telement(499, my_tlist));
+
+	if (delete_tlist(my_tlist)) {
+		return 31;
+	}
+
+	/* Leaves holding one element are made to hold two, so they split */
+	struct tlist_t *tiny_tlist = create_tlist_with_allocator(sizeof (int), 1, NULL);
+	if (!tiny_tlist) {
+		return 31;
+	}
+	for (int i = 0; i < 64; i++) {
+		*(int *) add_telement(i / 3, tiny_tlist) = i;
+	}
+	for (int i = 0; i < 32; i++) {
+		remove_telement(i, tiny_tlist);
+	}
+	if (tlist_verify(tiny_tlist) || *(int *) get_telement(0, tiny_tlist) != 5
+	    || delete_tlist(tiny_tlist)) {
+		return 31;
+	}
+
+	/* Add many elements at once, copying their data from an array */
+	int array[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+	struct list_t *first_list = create_list(sizeof (int));
+	struct list_t *second_list = create_list(sizeof (int));
+	if (!first_list || !second_list) {
+		return 32;
+	}
+	if (!add_elements(0, array, 8, first_list)
+	    || !add_elements(0, array, 4, second_list)) {
+		return 33;
+	}
+
+	/* Remove the elements from #2 to #5 at once */
+	if (remove_elements(2, 4, first_list)) {
+		return 34;
+	}
+
+	/* Move the elements of the second list into the first one, and
+	 * the last three elements of the first list into a new list */
+	if (splice_list(2, second_list, first_list)) {
+		return 35;
+	}
+	struct list_t *third_list = split_list(5, first_list);
+	if (!third_list || list_verify(first_list) || list_verify(third_list)) {
+		return 36;
+	}
+
+	printf("Split lists:");
+	for (element = first_list->base->next; element; element = element->next) {
+		printf(" %i", *(int *) element->data);
+	}
+	printf(" |");
+	for (element = third_list->base->next; element; element = element->next) {
+		printf(" %i", *(int *) element->data);
+	}
+	printf("\n");
+
+	if (delete_list(first_list) || delete_list(second_list)
+	    || delete_list(third_list)) {
+		return 37;
+	}
+
+	/* Create a list in a file, it is kept in the file after closing it */
+	struct mlist_t *my_mlist = create_mlist("mlist.bin", sizeof (int));
+	if (!my_mlist) {
+		return 38;
+	}
+	for (int i = 0; i < 1000; i++) {
+		*(int *) add_melement(get_mlist_size(my_mlist), my_mlist) = i;
+	}
+	remove_melement(0, my_mlist);
+	off_t mlist_length = (off_t) my_mlist->header->length;
+	if (sync_mlist(my_mlist) || close_mlist(my_mlist)) {
+		return 39;
+	}
+
+	/* A crash after growing the file and before writing its new length
+	 * leaves a longer file, which still opens */
+	if (truncate("mlist.bin", mlist_length * 2)) {
+		return 39;
+	}
+
+	/* Opening the file again does not read any of its elements */
+	my_mlist = open_mlist("mlist.bin");
+	if (!my_mlist || mlist_verify(my_mlist)) {
+		return 40;
+	}
+	printf("Number of elements in mapped list: %zu, element #0: %i\n",
+	       get_mlist_size(my_mlist), *(int *) get_melement(0, my_mlist));
+
+	/* A file whose header points past its elements is not opened */
+	my_mlist->header->head = (uint64_t) 1 << 40;
+	if (close_mlist(my_mlist) || open_mlist("mlist.bin") || remove("mlist.bin")) {
+		return 41;
+	}
+
+	/* Save a list into a file with a checksum and load it back */
+	struct list_t *saved_list = create_list(sizeof (int));
+	if (!saved_list || !add_elements(0, array, 8, saved_list)) {
+		return 42;
+	}
+	int fd = open("list.bin", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0 || write_list(fd, LISTIO_CHECKSUM, saved_list)) {
+		return 43;
+	}
+	lseek(fd, 0, SEEK_SET);
+	struct list_t *loaded_list = read_list(fd, sizeof (int));
+	if (!loaded_list || close(fd) || remove("list.bin")) {
+		return 44;
+	}
+	printf("Number of elements in loaded list: %zu, last element: %i\n",
+	       get_list_size(loaded_list), *(int *) loaded_list->tail->data);
+
+	if (delete_list(saved_list) || delete_list(loaded_list)) {
+		return 45;
+	}
+
+	/* Scan the chunks of an unrolled list of numbers with the kernels */
+	struct ulist_t *number_ulist = create_ulist(sizeof (int32_t));
+	if (!number_ulist) {
+		return 46;
+	}
+	for (int32_t i = 0; i < 1000; i++) {
+		*(int32_t *) add_uelement((size_t) i, number_ulist) = i % 100;
+	}
+	int32_t number = 42;
+	int64_t number_sum = 0;
+	int32_t number_max = 0;
+	if (reduce_uvalues(LIST_SUM, LIST_INT32, &number_sum, number_ulist)
+	    || reduce_uvalues(LIST_MAX, LIST_INT32, &number_max, number_ulist)) {
+		return 47;
+	}
+	/* The list does not hold doubles, they are not scanned */
+	double number_double = 42;
+	if (find_uvalue(&number_double, LIST_DOUBLE, number_ulist) != 1000
+	    || count_uvalues(&number_double, LIST_DOUBLE, number_ulist)
+	    || reduce_uvalues(LIST_SUM, LIST_DOUBLE, &number_double, number_ulist) != 4) {
+		return 47;
+	}
+	printf("Scanned: %zu %zu %li %i\n",
+	       find_uvalue(&number, LIST_INT32, number_ulist),
+	       count_uvalues(&number, LIST_INT32, number_ulist),
+	       (long) number_sum, number_max);
+
+	if (delete_ulist(number_ulist)) {
+		return 48;
+	}
+
+	/* The values of a typed list are stored in its elements */
+	struct double_list_t *my_double_list = double_list_create();
+	if (!my_double_list) {
+		return 49;
+	}
+	for (int i = 0; i < 100; i++) {
+		if (!double_list_push_back(i * 0.5, my_double_list)) {
+			return 50;
+		}
+	}
+	double_list_push_front(-1.0, my_double_list);
+	double_list_insert(50, 100.0, my_double_list);
+	double_list_erase(1, my_double_list);
+	double double_sum = 0;
+	for (size_t i = 0; i < double_list_size(my_double_list); i++) {
+		double_sum += *double_list_at(i, my_double_list);
+	}
+	if (double_list_verify(my_double_list)) {
+		return 51;
+	}
+	printf("Typed list: %zu %g %g\n", double_list_size(my_double_list),
+	       *double_list_front(my_double_list), double_sum);
+
+	if (double_list_delete(my_double_list)) {
+		return 52;
+	}
+
+	/* Sort two lists, merge them and remove the repeated elements */
+	int unsorted[8] = { 5, 3, 9, 1, 3, 7, 2, 8 };
+	struct list_t *sorted_list = create_list(sizeof (int));
+	struct list_t *other_list = create_list(sizeof (int));
+	if (!sorted_list || !other_list || !add_elements(0, unsorted, 5, sorted_list)
+	    || !add_elements(0, unsorted + 5, 3, other_list)) {
+		return 53;
+	}
+	if (sort_list(compare_ints, sorted_list) || sort_list(compare_ints, other_list)
+	    || merge_list(other_list, compare_ints, sorted_list)
+	    || unique_list(compare_ints, sorted_list) || list_verify(sorted_list)) {
+		return 54;
+	}
+	printf("Sorted list:");
+	for (struct element_t *sorted = (struct element_t *) sorted_list->base->next;
+	     sorted; sorted = (struct element_t *) sorted->next) {
+		printf(" %i", *(int *) sorted->data);
+	}
+	printf("\n");
+
+	if (delete_list(sorted_list) || delete_list(other_list)) {
+		return 55;
+	}
+
+	/* Cache the squares of the last three numbers used, an indexed list
+	 * finds them and moves the used one to the front */
+	int requests[8] = { 4, 2, 4, 7, 9, 2, 4, 9 };
+	int cache_misses = 0;
+	struct ilist_t *cache = create_ilist(sizeof (int[2]), get_int_key, hash_int,
+	                                     compare_ints);
+	if (!cache) {
+		return 56;
+	}
+	for (int i = 0; i < 8; i++) {
+		struct delement_t *cached = find_ielement(&requests[i], cache);
+		if (cached) {
+			move_delement(cached, (struct delement_t *) cache->list->base->next,
+			              cache->list);
+			continue;
+		}
+		int square[2] = { requests[i], requests[i] * requests[i] };
+		if (!add_ielement(0, square, cache)) {
+			return 57;
+		}
+		if (get_ilist_size(cache) > 3 && remove_ielement(3, cache)) {
+			return 57;
+		}
+		cache_misses++;
+	}
+	if (ilist_verify(cache)) {
+		return 58;
+	}
+	printf("Cached squares:");
+	for (struct delement_t *cached = (struct delement_t *) cache->list->base->next;
+	     cached != cache->list->base; cached = (struct delement_t *) cached->next) {
+		printf(" %i", ((int *) cached->data)[1]);
+	}
+	printf(", %i misses\n", cache_misses);
+
+	if (delete_ilist(cache)) {
+		return 59;
+	}
+
+	/* A list on the stack and an intrusive list of packets on the stack,
+	 * none of them allocate their list or base */
+	struct list_t stack_list;
+	struct list_t packet_list;
+	struct packet_t packets[4] = { { 60, { NULL, NULL } }, { 1500, { NULL, NULL } },
+		{ 40, { NULL, NULL } }, { 576, { NULL, NULL } }
+	};
+	if (list_init(sizeof (int), NULL, &stack_list) || list_init_intrusive(&packet_list)
+	    || !add_elements(0, unsorted, 8, &stack_list)) {
+		return 60;
+	}
+	for (int i = 0; i < 4; i++) {
+		if (link_element(get_list_size(&packet_list), &packets[i].link, &packet_list)) {
+			return 61;
+		}
+	}
+	struct element_t *unlinked = unlink_element(1, &packet_list);
+	if (!unlinked || add_element(0, &packet_list) || list_verify(&packet_list)
+	    || list_verify(&stack_list)) {
+		return 61;
+	}
+	int packet_lengths = 0;
+	for (struct element_t *link = (struct element_t *) packet_list.base->next;
+	     link; link = (struct element_t *) link->next) {
+		packet_lengths += container_of(link, struct packet_t, link)->length;
+	}
+	printf("Stack list: %zu, packets: %zu %i, unlinked %i\n",
+	       get_list_size(&stack_list), get_list_size(&packet_list), packet_lengths,
+	       container_of(unlinked, struct packet_t, link)->length);
+
+	if (list_destroy(&stack_list) || list_destroy(&packet_list)) {
+		return 62;
+	}
+
+#ifdef LIST_STATS
+	/* Count what a list does, getting the elements backwards walks it */
+	struct list_t counted_list;
+	struct list_stats_t stats;
+	if (list_init(sizeof (int), NULL, &counted_list)
+	    || !add_elements(0, unsorted, 8, &counted_list)) {
+		return 63;
+	}
+	for (size_t i = get_list_size(&counted_list); i > 0; i--) {
+		get_element(i - 1, &counted_list);
+	}
+	if (remove_element(0, &counted_list) || list_get_stats(&stats, &counted_list)) {
+		return 64;
+	}
+	printf("Stats: %zu adds, %zu removes, %zu gets walking %zu, %zu allocations, "
+	       "%zu frees, at most %zu\n", stats.adds, stats.removes, stats.gets,
+	       stats.walked, stats.allocations, stats.frees, stats.max_size);
+
+	/* The registry has every list that is not deleted or destroyed */
+	FILE *stats_file = tmpfile();
+	if (!stats_file || list_dump_stats(stats_file) || list_destroy(&counted_list)) {
+		return 65;
+	}
+	fclose(stats_file);
+#endif
 	return 0;
 }
 
@@ -136,4 +710,26 @@ int main(void)
  * Element #2: 20
  * Number of elements in list: 2
  * Number of elements in list: 0
+ * Number of elements in list: 1000
+ * Number of elements in pooled list: 1000
+ * Element: 30
+ * Element: 15
+ * Element: 10
+ * Sum of elements in unrolled list: 250000
+ * Number of elements in lock-free list: 50
+ * Enqueued 16 elements, the first one is 1
+ * Elements from 500 to 503: 500 501 502 503, element #10: 11
+ * Element #0: 3, element #499: 0
+ * Split lists: 1 2 1 2 3 | 4 7 8
+ * Number of elements in mapped list: 999, element #0: 1
+ * Number of elements in loaded list: 8, last element: 8
+ * Scanned: 42 10 49500 99
+ * Typed list: 101 -1 2574
+ * Sorted list: 1 2 3 5 7 8 9
+ * Cached squares: 81 16 4, 6 misses
+ * Stack list: 8, packets: 3 676, unlinked 1500
+ *
+ * And with LIST_STATS defined:
+ *
+ * Stats: 8 adds, 1 removes, 10 gets walking 21, 8 allocations, 1 frees, at most 8
  */
@@ -22,9 +22,46 @@
 // Feature tests for the C++ Wrapper for the Minimal C List
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <iostream>
+#include <memory_resource>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 #define LIST_IMPL
 #include "list.hpp"
+#include "dlist.hpp"
+#include "ulist.hpp"
+#include "lflist.hpp"
+#include "lqueue.hpp"
+#include "tlist.hpp"
+#include "listio.hpp"
+#include "parallel.hpp"
+#include "scan.hpp"
+#include "ilist.hpp"
+#include "smlist.hpp"
+
+// Strings are not trivially copyable, they are saved by a serializer
+template<>
+struct aplib::serializer<std::string>
+{
+	static void write(std::ostream &stream, const std::string &value)
+	{
+		stream << value.size() << ' ' << value;
+	}
+	static std::string read(std::istream &stream)
+	{
+		size_t size = 0;
+		std::string value;
+		stream >> size;
+		stream.get();
+		value.resize(size);
+		stream.read(&value[0], size);
+		return value;
+	}
+};
 
 int main()
 {
@@ -80,6 +117,14 @@ int main()
 		          << number << std::endl;
 	}
 
+	// Iterators work with the standard algorithms
+	std::cout << "Sum of elements: "
+	          << std::accumulate(myList.cbegin(), myList.cend(), 0)
+	          << std::endl;
+	std::cout << "Found 60: " << std::boolalpha
+	          << (std::find(myList.begin(), myList.end(), 60) != myList.end())
+	          << std::endl;
+
 	// Remove an element from the end of a list
 	myList.erase(myList.size() - 1);
 
@@ -97,6 +142,215 @@ int main()
 	std::cout << "Number of elements in list: "
 	          << myList.size() << std::endl;
 
+	// Lists can use standard allocators, including polymorphic ones
+	std::pmr::unsynchronized_pool_resource resource;
+	aplib::list<int, std::pmr::polymorphic_allocator<int>> pmrList(&resource);
+	for (int i = 0; i < 1000; i++) {
+		pmrList.push_back(i);
+	}
+
+	// Print the size of the list again
+	std::cout << "Number of elements in pmr list: "
+	          << pmrList.size() << std::endl;
+
+	// Lists hold any type, values are constructed in place
+	aplib::list<std::string> names;
+	names.emplace_back(3, 'b');
+	names.emplace_front("aaa");
+	names.push_back(std::string("ccc"));
+
+	// Copy a list, and move a list without copying the values
+	aplib::list<std::string> copied = names;
+	aplib::list<std::string> moved = std::move(names);
+	copied.pop_back();
+	// A moved from list is empty and can be used again
+	names.push_back("ddd").emplace_front("eee");
+	for (const std::string &name : moved) {
+		std::cout << name << " ";
+	}
+	std::cout << "and " << copied.size() << " copied, " << names.size()
+	          << " after moving" << std::endl;
+
+	// Doubly linked lists add and remove at both ends and at iterators
+	// without walking, and their iterators can move back
+	aplib::dlist<int> queue;
+	queue.push_back(2);
+	queue.push_back(3);
+	queue.push_front(1);
+	queue.pop_back();
+	auto position = queue.insert(queue.end(), 4);
+	queue.erase(std::prev(position));
+	for (auto it = queue.end(); it != queue.begin();) {
+		std::cout << *--it << " ";
+	}
+	std::cout << "in reverse" << std::endl;
+
+	// Unrolled lists keep elements next to each other in chunks
+	aplib::ulist<int> numbers;
+	for (int i = 1; i <= 100; i++) {
+		numbers.push_back(i);
+	}
+	std::cout << "Sum of elements in unrolled list: "
+	          << std::accumulate(numbers.begin(), numbers.end(), 0)
+	          << std::endl;
+
+	// Concurrent lists are used by many threads through their sessions
+	aplib::concurrent_list<int> shared;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([&shared, t]() {
+			auto session = shared.join();
+			for (int i = 0; i < 100; i++) {
+				session.push_front(t * 100 + i);
+			}
+			session.remove_if([](int value) { return value % 2; });
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	std::cout << "Number of elements in concurrent list: "
+	          << shared.size() << std::endl;
+
+	// Queues hand values from many threads to one thread
+	aplib::queue<int> pipeline(64, LQUEUE_MPSC);
+	threads.clear();
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([&pipeline]() {
+			for (int i = 1; i <= 100; i++) {
+				while (!pipeline.push(i)) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	int received = 0;
+	long total = 0;
+	while (received < 400) {
+		int value = 0;
+		if (pipeline.pop(value)) {
+			received++;
+			total += value;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	std::cout << "Sum of values through the queue: " << total << std::endl;
+
+	// Tree lists add, remove and access at an index without walking
+	aplib::tlist<int> tree;
+	for (int i = 0; i < 1000; i++) {
+		tree.insert(tree.size() / 2, i);
+	}
+	tree.erase(0);
+	std::cout << "Tree list: " << tree.front() << " " << tree[499]
+	          << " " << *std::prev(tree.end()) << std::endl;
+
+	// Ranges are added and removed at once, and lists are moved into
+	// each other or split without copying their elements
+	int range[] = {1, 2, 3, 4, 5};
+	aplib::list<int> joined;
+	aplib::list<int> other;
+	joined.insert(0, std::begin(range), std::end(range));
+	other.insert(0, std::begin(range), std::end(range));
+	joined.splice(joined.size(), other);
+	joined.erase(2, 4);
+	aplib::list<int> rest = joined.split(3);
+	std::cout << "Spliced and split: " << joined.size() << " " << other.size()
+	          << " " << rest.front() << " " << rest.back() << std::endl;
+
+	// Lists are saved into streams and loaded back
+	std::stringstream saved;
+	aplib::list<std::string> words;
+	aplib::list<std::string> loaded_words;
+	aplib::list<int> loaded;
+	words.push_back("saved").push_back("and loaded");
+	aplib::write_list(saved, joined, LISTIO_CHECKSUM);
+	aplib::write_list(saved, words);
+	aplib::read_list(saved, loaded);
+	aplib::read_list(saved, loaded_words);
+	std::cout << "Loaded: " << loaded.size() << " " << loaded.back() << " "
+	          << loaded_words.front() << " " << loaded_words.back();
+	// A stream cut short leaves the list empty
+	std::stringstream cut;
+	aplib::write_list(cut, joined, LISTIO_CHECKSUM);
+	std::string data = cut.str();
+	std::stringstream cut_short(data.substr(0, data.size() - 1));
+	aplib::read_list(cut_short, loaded);
+	std::cout << ", " << loaded.size() << " from a cut stream" << std::endl;
+
+	// Algorithms split the list between the threads of a pool
+	aplib::list<int> scores;
+	for (int i = 1; i <= 10000; i++) {
+		scores.push_back(i);
+	}
+	aplib::parallel::for_each(scores, [](int &score) {
+		score *= 2;
+	});
+	long score_sum = aplib::parallel::reduce(scores, 0L, [](long a, long b) {
+		return a + b;
+	});
+	size_t high_scores = aplib::parallel::count_if(scores, [](int score) {
+		return score > 10000;
+	});
+	std::cout << "Parallel: " << score_sum << " " << high_scores << std::endl;
+
+	// Unrolled lists of numbers are scanned by the vectorized kernels
+	aplib::ulist<double> readings;
+	for (int i = 0; i < 1000; i++) {
+		readings.push_back(i % 10 * 0.5);
+	}
+	std::cout << "Scanned: " << aplib::find_value(readings, 2.0) << " "
+	          << aplib::count_values(readings, 2.0) << " "
+	          << aplib::sum_values(readings) << " "
+	          << aplib::max_value(readings) << " "
+	          << aplib::min_value(scores) << std::endl;
+
+	// Sorting relinks the elements, merging takes the values of a sorted list
+	aplib::list<std::string> guests;
+	aplib::list<std::string> other_guests;
+	guests.push_back("carol").push_back("alice").push_back("bob");
+	other_guests.push_back("bob").push_back("dave");
+	guests.sort().merge(other_guests).unique();
+	std::cout << "Sorted:";
+	for (const std::string &guest : guests) {
+		std::cout << " " << guest;
+	}
+	// The unrolled list copies the values it keeps down
+	aplib::ulist<int> steps;
+	for (int i = 0; i < 100; i++) {
+		steps.push_back(i / 10);
+	}
+	steps.unique();
+	std::cout << ", " << steps.size() << " steps " << steps.back() << std::endl;
+
+	// Indexed lists find the values of their keys and keep them in order
+	aplib::indexed_list<std::string, int> ages;
+	ages.emplace_back("carol", 31);
+	ages.emplace_back("alice", 27);
+	ages["bob"] = 45;
+	ages.emplace_front("alice", 99);
+	ages.move_to_front(ages.find("bob"));
+	ages.erase("carol");
+	std::cout << "Indexed:";
+	for (const auto &age : ages) {
+		std::cout << " " << age.first << "=" << age.second;
+	}
+	std::cout << " " << ages.contains("carol") << std::endl;
+
+	// Small lists keep their first elements inside, the rest are allocated
+	aplib::small_list<int, 4> digits;
+	for (int i = 1; i <= 6; i++) {
+		digits.push_back(i);
+	}
+	digits.pop_front().erase(2);
+	std::cout << "Small list: " << digits.size() << " " << digits.front() << " "
+	          << digits.back() << " " << std::accumulate(digits.begin(),
+	                  digits.end(), 0) << std::endl;
+
 	// List is automatically deleted when it goes out of scope
 }
 
@@ -111,5 +365,21 @@ int main()
 // Element #0: 40
 // Element #1: 60
 // Element #2: 20
+// Sum of elements: 120
+// Found 60: true
 // Number of elements in list: 2
 // Number of elements in list: 0
+// Number of elements in pmr list: 1000
+// aaa bbb ccc and 2 copied, 2 after moving
+// 4 1 in reverse
+// Sum of elements in unrolled list: 5050
+// Number of elements in concurrent list: 200
+// Sum of values through the queue: 20200
+// Tree list: 3 998 0
+// Spliced and split: 3 0 3 5
+// Loaded: 3 2 saved and loaded, 0 from a cut stream
+// Parallel: 100010000 5000
+// Scanned: 4 100 2250 4.5 2
+// Sorted: alice bob carol dave, 10 steps 9
+// Indexed: bob=45 alice=27 false
+// Small list: 4 2 6 16
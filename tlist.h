@@ -0,0 +1,881 @@
+/*
+ * Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * A Minimal C Counted Tree List
+ *   Usage and other information is provided in the README.md file from the
+ *   repository. Please refer to that to know how to use this library.
+ */
+
+#ifndef TLIST_H
+#define TLIST_H "tlist.h"
+
+#include <string.h>
+
+/* The tree list uses the allocators of the list */
+#include "list.h"
+
+/* Implement the list code by defining
+ * LIST_IMPL before including this library */
+
+/* The default size of a leaf in bytes, including its header */
+#ifndef TLIST_CHUNK_SIZE
+#define TLIST_CHUNK_SIZE 512
+#endif
+
+/* The maximum number of children of a node of the tree */
+#ifndef TLIST_FANOUT
+#define TLIST_FANOUT 16
+#endif
+
+/* Elements are kept next to each other in leaves like the chunks of the
+ * unrolled list, and the leaves are linked in both directions. The leaves
+ * are the bottom of a B+ tree counting the elements under every node, so
+ * finding an index goes down the tree instead of walking the leaves */
+struct tleaf_t {
+	void *parent;
+	void *next;
+	void *prev;
+	size_t count;
+};
+
+/* The parent is first in both the nodes and the leaves */
+struct tnode_t {
+	void *parent;
+	size_t count;
+	/* The number of elements under each child */
+	size_t sizes[TLIST_FANOUT];
+	void *children[TLIST_FANOUT];
+};
+
+struct tlist_t {
+	/* The root is a leaf if the height is 0, NULL if the list is empty */
+	void *root;
+	size_t height;
+	/* The first and the last leaf, there are no empty leaves */
+	struct tleaf_t *head;
+	struct tleaf_t *tail;
+	size_t size;
+	size_t typesize;
+	/* The number of elements a leaf can hold */
+	size_t capacity;
+	/* Leaves and nodes are allocated using malloc if there is no allocate */
+	struct list_allocator_t allocator;
+};
+
+
+/* The capacity of a leaf is chosen to fit TLIST_CHUNK_SIZE bytes */
+struct tlist_t *create_tlist(size_t typesize);
+/* The allocator is copied into the list, the leaves are allocated using
+ * malloc if the allocator is NULL. A capacity of 0 uses the default,
+ * a leaf holds at least 2 elements */
+struct tlist_t *create_tlist_with_allocator(size_t typesize, size_t capacity,
+                                            const struct list_allocator_t *allocator);
+
+/* Elements are not separate allocations, these
+ * functions give the pointers to their data */
+void *get_telement(size_t index, struct tlist_t *list);
+size_t get_tlist_size(struct tlist_t *list);
+
+/* Define LIST_DEBUG to check the size, the
+ * leaves and the nodes of a list */
+#ifdef LIST_DEBUG
+int tlist_verify(struct tlist_t *list);
+size_t verify_tchild(void *child, void *parent, size_t level,
+                     struct tleaf_t **leaf, int *error, struct tlist_t *list);
+#endif
+
+/* These functions are not supposed to be used externally */
+struct tleaf_t *create_tleaf(struct tlist_t *list);
+int delete_tleaf(struct tleaf_t *leaf, struct tlist_t *list);
+struct tnode_t *create_tnode(struct tlist_t *list);
+int delete_tnode(struct tnode_t *node, struct tlist_t *list);
+struct tleaf_t *find_tleaf(size_t index, size_t *first, struct tlist_t *list);
+void *get_tleaf_data(struct tleaf_t *leaf, size_t offset, struct tlist_t *list);
+size_t get_tleaf_index(struct tleaf_t *leaf, struct tlist_t *list);
+size_t get_tchild_slot(void *child);
+size_t get_tchild_size(void *child, size_t level);
+void add_tsize(void *child, size_t size);
+void insert_tchild(void *prev, void *child, size_t size, size_t level,
+                   struct tnode_t **spare, struct tlist_t *list);
+void remove_tchild(void *child, size_t level, struct tlist_t *list);
+void merge_tnode(struct tnode_t *node, size_t level, struct tlist_t *list);
+void merge_tleaf(struct tleaf_t *leaf, struct tlist_t *list);
+
+/* You can add element at the end of the list by giving it the size of the
+ * list. Elements after the index in the same leaf move in memory, so the
+ * pointers to them are no longer valid after adding or removing */
+void *add_telement(size_t index, struct tlist_t *list);
+int remove_telement(size_t index, struct tlist_t *list);
+
+int clear_tlist(struct tlist_t *list);
+int delete_tlist(struct tlist_t *list);
+
+#ifdef LIST_IMPL
+
+struct tlist_t *create_tlist(size_t typesize)
+{
+	return create_tlist_with_allocator(typesize, 0, NULL);
+}
+
+struct tlist_t *create_tlist_with_allocator(size_t typesize, size_t capacity,
+                                            const struct list_allocator_t *allocator)
+{
+	struct tlist_t *list = NULL;
+	size_t offset = align_data_offset(sizeof(struct tleaf_t), typesize);
+
+	/* Fit the leaf in the default size, holding at least a few elements */
+	if (capacity == 0) {
+		if (typesize && offset + typesize * 4 < TLIST_CHUNK_SIZE) {
+			capacity = (TLIST_CHUNK_SIZE - offset) / typesize;
+		} else {
+			capacity = 4;
+		}
+	}
+	/* A full leaf is split in two halves, each keeping an element */
+	if (capacity < 2) {
+		capacity = 2;
+	}
+
+	list = (struct tlist_t *) malloc(sizeof(struct tlist_t));
+	if (!list) {
+		return NULL;
+	}
+
+	list->root = NULL;
+	list->height = 0;
+	list->head = NULL;
+	list->tail = NULL;
+	list->size = 0;
+	list->typesize = typesize;
+	list->capacity = capacity;
+	list->allocator.allocate = NULL;
+	list->allocator.deallocate = NULL;
+	list->allocator.release = NULL;
+	list->allocator.context = NULL;
+	if (allocator) {
+		list->allocator = *allocator;
+	}
+	return list;
+}
+
+void *get_telement(size_t index, struct tlist_t *list)
+{
+	struct tleaf_t *leaf = NULL;
+	size_t first = 0;
+
+	leaf = find_tleaf(index, &first, list);
+	if (!leaf) {
+		return NULL;
+	}
+	return get_tleaf_data(leaf, index - first, list);
+}
+
+size_t get_tlist_size(struct tlist_t *list)
+{
+	if (!list) {
+		return 0;
+	}
+	return list->size;
+}
+
+#ifdef LIST_DEBUG
+int tlist_verify(struct tlist_t *list)
+{
+	struct tleaf_t *leaf = NULL;
+	struct tleaf_t *prev = NULL;
+	size_t size = 0;
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+	leaf = list->head;
+
+	/* Stop after the size is exceeded, in case the links have a loop */
+	while (leaf && size <= list->size) {
+		if (leaf->prev != (void *) prev) {
+			return 2;
+		}
+		if (leaf->count == 0 || leaf->count > list->capacity) {
+			return 3;
+		}
+		size += leaf->count;
+		prev = leaf;
+		leaf = (struct tleaf_t *) leaf->next;
+	}
+
+	if (size != list->size) {
+		return 5;
+	}
+	if (list->tail != prev) {
+		return 6;
+	}
+	if (!list->root) {
+		return list->head ? 7 : 0;
+	}
+
+	/* The tree has the leaves in the same order, and counts them right */
+	leaf = list->head;
+	if (verify_tchild(list->root, NULL, list->height, &leaf, &error, list) != size) {
+		return 8;
+	}
+	if (leaf) {
+		return 7;
+	}
+	return error;
+}
+
+size_t verify_tchild(void *child, void *parent, size_t level,
+                     struct tleaf_t **leaf, int *error, struct tlist_t *list)
+{
+	struct tnode_t *node = (struct tnode_t *) child;
+	size_t size = 0;
+
+	if (*(void **) child != parent) {
+		*error = 9;
+	}
+	if (level == 0) {
+		if (child != (void *) *leaf) {
+			*error = 7;
+			return 0;
+		}
+		*leaf = (struct tleaf_t *) (*leaf)->next;
+		return ((struct tleaf_t *) child)->count;
+	}
+
+	if (node->count == 0 || node->count > TLIST_FANOUT) {
+		*error = 10;
+		return 0;
+	}
+	for (size_t i = 0; i < node->count; i++) {
+		if (verify_tchild(node->children[i], child, level - 1, leaf, error, list)
+		    != node->sizes[i]) {
+			*error = 8;
+		}
+		size += node->sizes[i];
+	}
+	return size;
+}
+#endif
+
+
+
+struct tleaf_t *create_tleaf(struct tlist_t *list)
+{
+	struct tleaf_t *leaf = NULL;
+	size_t size = 0;
+
+	if (!list) {
+		return NULL;
+	}
+
+	size = align_data_offset(sizeof(struct tleaf_t), list->typesize)
+	       + list->typesize * list->capacity;
+	if (list->allocator.allocate) {
+		leaf = (struct tleaf_t *) list->allocator.allocate(list->allocator.context, size);
+	} else {
+		leaf = (struct tleaf_t *) malloc(size);
+	}
+	if (!leaf) {
+		return NULL;
+	}
+
+	leaf->parent = NULL;
+	leaf->next = NULL;
+	leaf->prev = NULL;
+	leaf->count = 0;
+	return leaf;
+}
+
+int delete_tleaf(struct tleaf_t *leaf, struct tlist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (!leaf) {
+		return 2;
+	}
+
+	if (list->allocator.deallocate) {
+		list->allocator.deallocate(list->allocator.context, leaf,
+		                           align_data_offset(sizeof(struct tleaf_t), list->typesize)
+		                           + list->typesize * list->capacity);
+	} else {
+		free(leaf);
+	}
+	return 0;
+}
+
+struct tnode_t *create_tnode(struct tlist_t *list)
+{
+	struct tnode_t *node = NULL;
+
+	if (!list) {
+		return NULL;
+	}
+
+	if (list->allocator.allocate) {
+		node = (struct tnode_t *) list->allocator.allocate(list->allocator.context,
+		                                                   sizeof(struct tnode_t));
+	} else {
+		node = (struct tnode_t *) malloc(sizeof(struct tnode_t));
+	}
+	if (!node) {
+		return NULL;
+	}
+
+	node->parent = NULL;
+	node->count = 0;
+	return node;
+}
+
+int delete_tnode(struct tnode_t *node, struct tlist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (!node) {
+		return 2;
+	}
+
+	if (list->allocator.deallocate) {
+		list->allocator.deallocate(list->allocator.context, node, sizeof(struct tnode_t));
+	} else {
+		free(node);
+	}
+	return 0;
+}
+
+struct tleaf_t *find_tleaf(size_t index, size_t *first, struct tlist_t *list)
+{
+	void *child = NULL;
+	struct tnode_t *node = NULL;
+	size_t i = 0;
+
+	if (!list || !first) {
+		return NULL;
+	}
+	if (index >= list->size) {
+		return NULL;
+	}
+
+	/* Go down the tree, skipping over the children before the index */
+	*first = 0;
+	child = list->root;
+	for (size_t level = list->height; level > 0; level--) {
+		node = (struct tnode_t *) child;
+		for (i = 0; index >= node->sizes[i]; i++) {
+			index -= node->sizes[i];
+			*first += node->sizes[i];
+		}
+		child = node->children[i];
+	}
+	return (struct tleaf_t *) child;
+}
+
+void *get_tleaf_data(struct tleaf_t *leaf, size_t offset, struct tlist_t *list)
+{
+	return (void *) ((char *) leaf
+	                 + align_data_offset(sizeof(struct tleaf_t), list->typesize)
+	                 + offset * list->typesize);
+}
+
+size_t get_tleaf_index(struct tleaf_t *leaf, struct tlist_t *list)
+{
+	void *child = (void *) leaf;
+	struct tnode_t *parent = (struct tnode_t *) leaf->parent;
+	size_t index = 0;
+	size_t slot = 0;
+
+	(void) list;
+
+	/* Go up the tree, counting the elements of the children before */
+	while (parent) {
+		slot = get_tchild_slot(child);
+		for (size_t i = 0; i < slot; i++) {
+			index += parent->sizes[i];
+		}
+		child = (void *) parent;
+		parent = (struct tnode_t *) parent->parent;
+	}
+	return index;
+}
+
+size_t get_tchild_slot(void *child)
+{
+	struct tnode_t *parent = (struct tnode_t *) *(void **) child;
+	size_t slot = 0;
+
+	while (parent->children[slot] != child) {
+		slot++;
+	}
+	return slot;
+}
+
+size_t get_tchild_size(void *child, size_t level)
+{
+	struct tnode_t *node = (struct tnode_t *) child;
+	size_t size = 0;
+
+	if (level == 0) {
+		return ((struct tleaf_t *) child)->count;
+	}
+	for (size_t i = 0; i < node->count; i++) {
+		size += node->sizes[i];
+	}
+	return size;
+}
+
+void add_tsize(void *child, size_t size)
+{
+	struct tnode_t *parent = (struct tnode_t *) *(void **) child;
+
+	/* The size wraps around to subtract */
+	while (parent) {
+		parent->sizes[get_tchild_slot(child)] += size;
+		child = (void *) parent;
+		parent = (struct tnode_t *) parent->parent;
+	}
+}
+
+void insert_tchild(void *prev, void *child, size_t size, size_t level,
+                   struct tnode_t **spare, struct tlist_t *list)
+{
+	struct tnode_t *parent = NULL;
+	struct tnode_t *sibling = NULL;
+	size_t half = TLIST_FANOUT / 2;
+	size_t slot = 0;
+	size_t moved = 0;
+
+	/* The sizes of the parents do not count the size of the child yet.
+	 * Full parents are split in half, going up to the root if needed */
+	for (;;) {
+		parent = (struct tnode_t *) *(void **) prev;
+
+		/* A new root holds the old root and the child */
+		if (!parent) {
+			parent = *spare;
+			*spare = (struct tnode_t *) parent->parent;
+			parent->parent = NULL;
+			parent->count = 2;
+			parent->children[0] = prev;
+			parent->sizes[0] = get_tchild_size(prev, level);
+			parent->children[1] = child;
+			parent->sizes[1] = size;
+			*(void **) prev = (void *) parent;
+			*(void **) child = (void *) parent;
+			list->root = (void *) parent;
+			list->height++;
+			return;
+		}
+
+		slot = get_tchild_slot(prev) + 1;
+		if (parent->count < TLIST_FANOUT) {
+			memmove(&parent->children[slot + 1], &parent->children[slot],
+			        (parent->count - slot) * sizeof(void *));
+			memmove(&parent->sizes[slot + 1], &parent->sizes[slot],
+			        (parent->count - slot) * sizeof(size_t));
+			parent->children[slot] = child;
+			parent->sizes[slot] = size;
+			parent->count++;
+			*(void **) child = (void *) parent;
+			add_tsize((void *) parent, size);
+			return;
+		}
+
+		/* The second half of the children moves to the sibling */
+		sibling = *spare;
+		*spare = (struct tnode_t *) sibling->parent;
+		sibling->count = TLIST_FANOUT - half;
+		memcpy(sibling->children, &parent->children[half], sibling->count * sizeof(void *));
+		memcpy(sibling->sizes, &parent->sizes[half], sibling->count * sizeof(size_t));
+		parent->count = half;
+		moved = 0;
+		for (size_t i = 0; i < sibling->count; i++) {
+			*(void **) sibling->children[i] = (void *) sibling;
+			moved += sibling->sizes[i];
+		}
+
+		/* Add the child to the half it belongs to */
+		if (slot <= half) {
+			memmove(&parent->children[slot + 1], &parent->children[slot],
+			        (parent->count - slot) * sizeof(void *));
+			memmove(&parent->sizes[slot + 1], &parent->sizes[slot],
+			        (parent->count - slot) * sizeof(size_t));
+			parent->children[slot] = child;
+			parent->sizes[slot] = size;
+			parent->count++;
+			*(void **) child = (void *) parent;
+			add_tsize((void *) parent, size - moved);
+		} else {
+			slot -= half;
+			memmove(&sibling->children[slot + 1], &sibling->children[slot],
+			        (sibling->count - slot) * sizeof(void *));
+			memmove(&sibling->sizes[slot + 1], &sibling->sizes[slot],
+			        (sibling->count - slot) * sizeof(size_t));
+			sibling->children[slot] = child;
+			sibling->sizes[slot] = size;
+			sibling->count++;
+			*(void **) child = (void *) sibling;
+			add_tsize((void *) parent, 0 - moved);
+			moved += size;
+		}
+
+		/* The sibling is added after the parent, one level up */
+		prev = (void *) parent;
+		child = (void *) sibling;
+		size = moved;
+		level++;
+	}
+}
+
+void remove_tchild(void *child, size_t level, struct tlist_t *list)
+{
+	struct tnode_t *parent = NULL;
+	struct tnode_t *empty = NULL;
+	size_t slot = 0;
+
+	/* The child does not count any elements anymore. Parents left
+	 * without children are removed as well, going up the tree */
+	for (;;) {
+		parent = (struct tnode_t *) *(void **) child;
+		slot = parent ? get_tchild_slot(child) : 0;
+		if (empty) {
+			delete_tnode(empty, list);
+		}
+		if (!parent) {
+			list->root = NULL;
+			list->height = 0;
+			return;
+		}
+
+		memmove(&parent->children[slot], &parent->children[slot + 1],
+		        (parent->count - slot - 1) * sizeof(void *));
+		memmove(&parent->sizes[slot], &parent->sizes[slot + 1],
+		        (parent->count - slot - 1) * sizeof(size_t));
+		parent->count--;
+		if (parent->count) {
+			break;
+		}
+		child = (void *) parent;
+		empty = parent;
+		level++;
+	}
+	merge_tnode(parent, level + 1, list);
+}
+
+void merge_tnode(struct tnode_t *node, size_t level, struct tlist_t *list)
+{
+	struct tnode_t *parent = (struct tnode_t *) node->parent;
+	struct tnode_t *left = NULL;
+	struct tnode_t *right = NULL;
+	size_t slot = 0;
+	size_t moved = 0;
+
+	/* A node below half full is merged with a sibling it fits in */
+	if (!parent || node->count >= TLIST_FANOUT / 2) {
+		return;
+	}
+	slot = get_tchild_slot((void *) node);
+	if (slot + 1 < parent->count) {
+		left = node;
+		right = (struct tnode_t *) parent->children[slot + 1];
+	} else if (slot > 0) {
+		left = (struct tnode_t *) parent->children[slot - 1];
+		right = node;
+	} else {
+		return;
+	}
+	if (left->count + right->count > TLIST_FANOUT) {
+		return;
+	}
+
+	memcpy(&left->children[left->count], right->children, right->count * sizeof(void *));
+	memcpy(&left->sizes[left->count], right->sizes, right->count * sizeof(size_t));
+	for (size_t i = 0; i < right->count; i++) {
+		*(void **) right->children[i] = (void *) left;
+		moved += right->sizes[i];
+	}
+	left->count += right->count;
+	right->count = 0;
+	add_tsize((void *) left, moved);
+	add_tsize((void *) right, 0 - moved);
+
+	remove_tchild((void *) right, level, list);
+	delete_tnode(right, list);
+}
+
+void merge_tleaf(struct tleaf_t *leaf, struct tlist_t *list)
+{
+	struct tleaf_t *left = NULL;
+	struct tleaf_t *right = NULL;
+
+	/* A leaf below half full is merged with a neighbor it fits in */
+	if (leaf->count >= list->capacity / 2) {
+		return;
+	}
+	if (leaf->next && leaf->count + ((struct tleaf_t *) leaf->next)->count
+	    <= list->capacity) {
+		left = leaf;
+		right = (struct tleaf_t *) leaf->next;
+	} else if (leaf->prev && leaf->count + ((struct tleaf_t *) leaf->prev)->count
+	           <= list->capacity) {
+		left = (struct tleaf_t *) leaf->prev;
+		right = leaf;
+	} else {
+		return;
+	}
+
+	memcpy(get_tleaf_data(left, left->count, list), get_tleaf_data(right, 0, list),
+	       right->count * list->typesize);
+	left->count += right->count;
+	add_tsize((void *) left, right->count);
+	add_tsize((void *) right, 0 - right->count);
+	right->count = 0;
+
+	left->next = right->next;
+	if (right->next) {
+		((struct tleaf_t *) right->next)->prev = (void *) left;
+	} else {
+		list->tail = left;
+	}
+	remove_tchild((void *) right, 0, list);
+	delete_tleaf(right, list);
+}
+
+
+
+void *add_telement(size_t index, struct tlist_t *list)
+{
+	struct tleaf_t *leaf = NULL;
+	struct tleaf_t *new_leaf = NULL;
+	struct tnode_t *spare = NULL;
+	struct tnode_t *node = NULL;
+	size_t first = 0;
+	size_t offset = 0;
+	size_t half = 0;
+	size_t needed = 0;
+	char *data = NULL;
+
+	if (!list) {
+		return NULL;
+	}
+	if (index > list->size) {
+		return NULL;
+	}
+
+	/* An empty list gets its first leaf */
+	if (!list->root) {
+		leaf = create_tleaf(list);
+		if (!leaf) {
+			return NULL;
+		}
+		list->root = (void *) leaf;
+		list->height = 0;
+		list->head = leaf;
+		list->tail = leaf;
+	} else if (index == list->size) {
+		leaf = list->tail;
+		first = list->size - leaf->count;
+	} else {
+		leaf = find_tleaf(index, &first, list);
+	}
+	offset = index - first;
+
+	/* A full leaf is split in half, the second half moves to a new
+	 * leaf. Adding at the end of the list leaves the full leaf as is */
+	if (leaf->count == list->capacity) {
+		/* Every full parent is split as well, and the root gets a parent
+		 * if all of them are full. The nodes are allocated beforehand so
+		 * that the tree is not left half split if allocating fails */
+		node = (struct tnode_t *) leaf->parent;
+		while (node && node->count == TLIST_FANOUT) {
+			node = (struct tnode_t *) node->parent;
+			needed++;
+		}
+		if (!node) {
+			needed++;
+		}
+
+		new_leaf = create_tleaf(list);
+		for (size_t i = 0; new_leaf && i < needed; i++) {
+			node = create_tnode(list);
+			if (!node) {
+				break;
+			}
+			node->parent = (void *) spare;
+			spare = node;
+		}
+		if (!new_leaf || !node) {
+			while (spare) {
+				node = spare;
+				spare = (struct tnode_t *) spare->parent;
+				delete_tnode(node, list);
+			}
+			if (new_leaf) {
+				delete_tleaf(new_leaf, list);
+			}
+			return NULL;
+		}
+
+		half = (offset == leaf->count) ? leaf->count : leaf->count / 2;
+		new_leaf->count = leaf->count - half;
+		memcpy(get_tleaf_data(new_leaf, 0, list), get_tleaf_data(leaf, half, list),
+		       new_leaf->count * list->typesize);
+		leaf->count = half;
+
+		new_leaf->prev = (void *) leaf;
+		new_leaf->next = leaf->next;
+		if (leaf->next) {
+			((struct tleaf_t *) leaf->next)->prev = (void *) new_leaf;
+		} else {
+			list->tail = new_leaf;
+		}
+		leaf->next = (void *) new_leaf;
+
+		/* The elements moved from the leaf to the new leaf */
+		add_tsize((void *) leaf, 0 - new_leaf->count);
+		insert_tchild((void *) leaf, (void *) new_leaf, new_leaf->count, 0, &spare, list);
+
+		if (offset >= half) {
+			leaf = new_leaf;
+			offset -= half;
+		}
+	}
+
+	data = (char *) get_tleaf_data(leaf, offset, list);
+	memmove(data + list->typesize, data, (leaf->count - offset) * list->typesize);
+	leaf->count++;
+	add_tsize((void *) leaf, 1);
+	list->size++;
+	return (void *) data;
+}
+
+int remove_telement(size_t index, struct tlist_t *list)
+{
+	struct tleaf_t *leaf = NULL;
+	struct tnode_t *root = NULL;
+	size_t first = 0;
+	size_t offset = 0;
+	char *data = NULL;
+
+	if (!list) {
+		return 1;
+	}
+	if (index >= list->size) {
+		return 3;
+	}
+
+	leaf = find_tleaf(index, &first, list);
+	if (!leaf) {
+		return 4;
+	}
+	offset = index - first;
+
+	data = (char *) get_tleaf_data(leaf, offset, list);
+	memmove(data, data + list->typesize, (leaf->count - offset - 1) * list->typesize);
+	leaf->count--;
+	add_tsize((void *) leaf, (size_t) -1);
+	list->size--;
+
+	/* An empty leaf is unlinked and deleted */
+	if (leaf->count == 0) {
+		if (leaf->prev) {
+			((struct tleaf_t *) leaf->prev)->next = leaf->next;
+		} else {
+			list->head = (struct tleaf_t *) leaf->next;
+		}
+		if (leaf->next) {
+			((struct tleaf_t *) leaf->next)->prev = leaf->prev;
+		} else {
+			list->tail = (struct tleaf_t *) leaf->prev;
+		}
+		remove_tchild((void *) leaf, 0, list);
+		delete_tleaf(leaf, list);
+	} else {
+		merge_tleaf(leaf, list);
+	}
+
+	/* A root with a single child is not needed */
+	while (list->height > 0 && ((struct tnode_t *) list->root)->count == 1) {
+		root = (struct tnode_t *) list->root;
+		list->root = root->children[0];
+		*(void **) list->root = NULL;
+		list->height--;
+		delete_tnode(root, list);
+	}
+	return 0;
+}
+
+int clear_tlist(struct tlist_t *list)
+{
+	struct tleaf_t *leaf = NULL;
+	struct tleaf_t *next = NULL;
+	struct tnode_t *node = NULL;
+	void *child = NULL;
+
+	if (!list) {
+		return 1;
+	}
+
+	/* The nodes are freed from the bottom, going up through the parents
+	 * once the last child of a node is freed. The leaves are linked */
+	for (leaf = list->head; leaf; leaf = next) {
+		next = (struct tleaf_t *) leaf->next;
+		child = (void *) leaf;
+		node = (struct tnode_t *) leaf->parent;
+		delete_tleaf(leaf, list);
+		while (node && node->children[node->count - 1] == child) {
+			child = (void *) node;
+			node = (struct tnode_t *) node->parent;
+			delete_tnode((struct tnode_t *) child, list);
+		}
+	}
+
+	list->root = NULL;
+	list->height = 0;
+	list->head = NULL;
+	list->tail = NULL;
+	list->size = 0;
+	return 0;
+}
+
+int delete_tlist(struct tlist_t *list)
+{
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+
+	error = clear_tlist(list);
+	if (error) {
+		return error;
+	}
+	free(list);
+	return 0;
+}
+
+/* LIST_IMPL */
+#endif
+
+/* TLIST_H */
+#endif
@@ -0,0 +1,356 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// The tree backend for the C++ Wrapper of the Minimal C Linked List
+//   Usage and other information is provided in the README.md file from the
+//   repository. Please refer to that to know how to use this library.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TLIST_HPP
+#define TLIST_HPP "tlist.hpp"
+
+// This header is just a wrapper for the Minimal C Counted Tree List
+#include "tlist.h"
+#include "list.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace aplib
+{
+// The tree backend keeps elements next to each other in leaves like the
+// unrolled backend, and finds an index by going down a tree counting
+// the elements, so adding, removing and accessing at an index do not walk
+struct counted_tree
+{
+	// A position is an element of a leaf, the end has no leaf
+	struct position_t
+	{
+		tleaf_t *leaf;
+		size_t offset;
+		tlist_t *list;
+
+		bool operator==(const position_t &compare) const;
+		bool operator!=(const position_t &compare) const;
+	};
+
+	using internal_t = tlist_t;
+	using iterator_category = std::bidirectional_iterator_tag;
+	// Elements are moved in memory when adding and removing
+	static constexpr bool moves_elements = true;
+
+	static internal_t *create(size_t typesize,
+	                          const list_allocator_t *allocator);
+	static int destroy(internal_t *list);
+	static int clear(internal_t *list);
+	static size_t size(internal_t *list);
+
+	static void *get(size_t index, internal_t *list);
+	static void *add(size_t index, internal_t *list);
+	static int remove(size_t index, internal_t *list);
+	static int remove(size_t index, size_t count, internal_t *list);
+
+	static position_t begin(internal_t *list);
+	static position_t end(internal_t *list);
+	static position_t next(position_t position);
+	static position_t prev(position_t position);
+	static void *data(position_t position);
+
+	// The index of a position is counted going up the tree
+	static position_t insert(position_t position, internal_t *list);
+	static position_t erase(position_t position, internal_t *list);
+
+	// Splicing and splitting copy the elements to the other list
+	static int splice(size_t index, internal_t *other, internal_t *list);
+	static internal_t *split(size_t index, internal_t *list);
+	// Sorting copies the elements out in order and back in
+	static int sort(int (*compare)(const void *, const void *, void *),
+	                void *context, internal_t *list);
+	// The kept elements are copied over the removed ones
+	static int unique(int (*compare)(const void *, const void *, void *),
+	                  void *context, internal_t *list);
+
+	// The position of an index, the end if it is past the last element
+	static position_t find(size_t index, internal_t *list);
+
+	// These functions are not supposed to be used externally
+	static size_t index(position_t position, internal_t *list);
+};
+
+template<typename type_t, typename alloc_t = std::allocator<type_t>>
+using tlist = list<type_t, alloc_t, counted_tree>;
+}
+
+#ifdef LIST_IMPL
+
+bool aplib::counted_tree::position_t::operator==(const position_t &compare) const
+{
+	return leaf == compare.leaf && offset == compare.offset;
+}
+
+bool aplib::counted_tree::position_t::operator!=(const position_t &compare) const
+{
+	return !(*this == compare);
+}
+
+aplib::counted_tree::internal_t *aplib::counted_tree::create(size_t typesize,
+        const list_allocator_t *allocator)
+{
+	return create_tlist_with_allocator(typesize, 0, allocator);
+}
+
+int aplib::counted_tree::destroy(internal_t *list)
+{
+	return delete_tlist(list);
+}
+
+int aplib::counted_tree::clear(internal_t *list)
+{
+	return clear_tlist(list);
+}
+
+size_t aplib::counted_tree::size(internal_t *list)
+{
+	return get_tlist_size(list);
+}
+
+void *aplib::counted_tree::get(size_t index, internal_t *list)
+{
+	return get_telement(index, list);
+}
+
+void *aplib::counted_tree::add(size_t index, internal_t *list)
+{
+	return add_telement(index, list);
+}
+
+int aplib::counted_tree::remove(size_t index, internal_t *list)
+{
+	return remove_telement(index, list);
+}
+
+int aplib::counted_tree::remove(size_t index, size_t count, internal_t *list)
+{
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+	if (count == 0) {
+		return 0;
+	}
+	if (index >= list->size || count > list->size - index) {
+		return 3;
+	}
+
+	// Removing from the last one keeps the elements after the range
+	// from moving more than once, and the last leaf is found at once
+	for (; count > 0 && !error; count--) {
+		error = remove_telement(index + count - 1, list);
+	}
+	return error;
+}
+
+aplib::counted_tree::position_t aplib::counted_tree::begin(internal_t *list)
+{
+	return position_t {list->head, 0, list};
+}
+
+aplib::counted_tree::position_t aplib::counted_tree::end(internal_t *list)
+{
+	return position_t {nullptr, 0, list};
+}
+
+aplib::counted_tree::position_t aplib::counted_tree::next(position_t position)
+{
+	if (++position.offset == position.leaf->count) {
+		position.leaf = (tleaf_t *) position.leaf->next;
+		position.offset = 0;
+	}
+	return position;
+}
+
+aplib::counted_tree::position_t aplib::counted_tree::prev(position_t position)
+{
+	// The end comes after the last element of the last leaf
+	if (!position.leaf) {
+		position.leaf = position.list->tail;
+		position.offset = position.leaf->count;
+	} else if (position.offset == 0) {
+		position.leaf = (tleaf_t *) position.leaf->prev;
+		position.offset = position.leaf->count;
+	}
+	position.offset--;
+	return position;
+}
+
+void *aplib::counted_tree::data(position_t position)
+{
+	return get_tleaf_data(position.leaf, position.offset, position.list);
+}
+
+aplib::counted_tree::position_t aplib::counted_tree::insert(position_t position,
+        internal_t *list)
+{
+	size_t added = index(position, list);
+
+	if (!add_telement(added, list)) {
+		return end(list);
+	}
+	return find(added, list);
+}
+
+aplib::counted_tree::position_t aplib::counted_tree::erase(position_t position,
+        internal_t *list)
+{
+	size_t removed = index(position, list);
+
+	remove_telement(removed, list);
+	return find(removed, list);
+}
+
+int aplib::counted_tree::splice(size_t index, internal_t *other, internal_t *list)
+{
+	position_t position = begin(other);
+	size_t added = 0;
+	void *element = nullptr;
+
+	if (other->typesize != list->typesize) {
+		return 2;
+	}
+	for (; position != end(other); position = next(position), added++) {
+		element = add_telement(index + added, list);
+		if (!element) {
+			while (added--) {
+				remove_telement(index, list);
+			}
+			return 2;
+		}
+		memcpy(element, data(position), list->typesize);
+	}
+	return clear_tlist(other);
+}
+
+aplib::counted_tree::internal_t *aplib::counted_tree::split(size_t index, internal_t *list)
+{
+	internal_t *split = create_tlist_with_allocator(list->typesize, list->capacity,
+	                    list->allocator.allocate ? &list->allocator : nullptr);
+	position_t position = find(index, list);
+	void *element = nullptr;
+
+	if (!split) {
+		return nullptr;
+	}
+	for (; position != end(list); position = next(position)) {
+		element = add_telement(split->size, split);
+		if (!element) {
+			destroy(split);
+			return nullptr;
+		}
+		memcpy(element, data(position), list->typesize);
+	}
+
+	// Removing from the end does not move any of the elements
+	while (list->size > index) {
+		remove_telement(list->size - 1, list);
+	}
+	return split;
+}
+
+int aplib::counted_tree::sort(int (*compare)(const void *, const void *, void *),
+                               void *context, internal_t *list)
+{
+	std::vector<void *> elements;
+	std::vector<char> sorted;
+	position_t position = begin(list);
+	size_t i = 0;
+
+	for (; position != end(list); position = next(position)) {
+		elements.push_back(data(position));
+	}
+	std::stable_sort(elements.begin(), elements.end(),
+	[compare, context](void *first, void *second) {
+		return compare(second, first, context) > 0;
+	});
+
+	// The elements are copied out in order and back into the list
+	sorted.resize(elements.size() * list->typesize);
+	for (i = 0; i < elements.size(); i++) {
+		memcpy(sorted.data() + i * list->typesize, elements[i], list->typesize);
+	}
+	for (i = 0, position = begin(list); position != end(list);
+	     i++, position = next(position)) {
+		memcpy(data(position), sorted.data() + i * list->typesize, list->typesize);
+	}
+	return 0;
+}
+
+int aplib::counted_tree::unique(int (*compare)(const void *, const void *, void *),
+                                void *context, internal_t *list)
+{
+	position_t kept = begin(list);
+	position_t position = begin(list);
+	size_t count = 1;
+
+	if (list->size < 2) {
+		return 0;
+	}
+
+	// The elements are trivially copyable, those after the kept ones
+	// are removed at once
+	for (position = next(position); position != end(list);
+	     position = next(position)) {
+		if (compare(data(kept), data(position), context)) {
+			kept = next(kept);
+			if (kept != position) {
+				memcpy(data(kept), data(position), list->typesize);
+			}
+			count++;
+		}
+	}
+	return remove(count, list->size - count, list);
+}
+
+size_t aplib::counted_tree::index(position_t position, internal_t *list)
+{
+	if (!position.leaf) {
+		return list->size;
+	}
+	return get_tleaf_index(position.leaf, list) + position.offset;
+}
+
+aplib::counted_tree::position_t aplib::counted_tree::find(size_t index,
+        internal_t *list)
+{
+	size_t first = 0;
+	tleaf_t *leaf = find_tleaf(index, &first, list);
+
+	if (!leaf) {
+		return end(list);
+	}
+	return position_t {leaf, index - first, list};
+}
+
+// LIST_IMPL
+#endif
+
+// TLIST_HPP
+#endif
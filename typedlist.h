@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Typed lists generated for a type from the Minimal C Linked List
+ *   Usage and other information is provided in the README.md file from the
+ *   repository. Please refer to that to know how to use this library.
+ */
+
+#ifndef TYPEDLIST_H
+#define TYPEDLIST_H "typedlist.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+/* The allocators and pools of a list work for typed lists as well */
+#include "list.h"
+
+/* LIST_DECLARE(name, type_t) declares a list of the type named struct
+ * name_t and its functions named name_..., put it in a header. Put
+ * LIST_DEFINE(name, type_t) in one source file to define the functions,
+ * like LIST_IMPL does for the other lists. The value is stored in the
+ * element itself, so the size of an element is known when compiling and
+ * nothing is copied through a void pointer. The functions used the most
+ * are static inline, they only call out to walk the list */
+
+#define LIST_DECLARE(name, type_t) \
+struct name##_element_t { \
+	struct name##_element_t *next; \
+	type_t data; \
+}; \
+\
+struct name##_t { \
+	/* The first and the last element, there is no base */ \
+	struct name##_element_t *head; \
+	struct name##_element_t *tail; \
+	/* The last accessed element and its index */ \
+	struct name##_element_t *cursor; \
+	size_t cursor_index; \
+	size_t size; \
+	/* Elements are allocated using malloc if there is no allocate */ \
+	struct list_allocator_t allocator; \
+}; \
+\
+struct name##_t *name##_create(void); \
+struct name##_t *name##_create_with_allocator( \
+        const struct list_allocator_t *allocator); \
+int name##_clear(struct name##_t *list); \
+int name##_delete(struct name##_t *list); \
+\
+/* Adding at the size of the list adds at the end */ \
+type_t *name##_insert(size_t index, type_t value, struct name##_t *list); \
+int name##_erase(size_t index, struct name##_t *list); \
+\
+/* These functions are not supposed to be used externally */ \
+struct name##_element_t *name##_find(size_t index, struct name##_t *list); \
+LIST_DECLARE_VERIFY(name) \
+\
+static inline size_t name##_size(struct name##_t *list) \
+{ \
+	return list ? list->size : 0; \
+} \
+\
+static inline struct name##_element_t *name##_create_element( \
+        struct name##_t *list) \
+{ \
+	if (list->allocator.allocate) { \
+		return (struct name##_element_t *) list->allocator.allocate( \
+		        list->allocator.context, sizeof(struct name##_element_t)); \
+	} \
+	return (struct name##_element_t *) malloc(sizeof(struct name##_element_t)); \
+} \
+\
+static inline void name##_delete_element(struct name##_element_t *element, \
+                                         struct name##_t *list) \
+{ \
+	if (list->allocator.deallocate) { \
+		list->allocator.deallocate(list->allocator.context, (void *) element, \
+		                           sizeof(struct name##_element_t)); \
+	} else { \
+		free(element); \
+	} \
+} \
+\
+/* The last accessed element, the one after it and the last element are \
+ * found without walking, so going through the indices in order is fast */ \
+static inline type_t *name##_at(size_t index, struct name##_t *list) \
+{ \
+	struct name##_element_t *element = NULL; \
+\
+	if (!list || index >= list->size) { \
+		return NULL; \
+	} \
+	if (index == list->size - 1) { \
+		return &list->tail->data; \
+	} \
+	if (list->cursor && index == list->cursor_index) { \
+		return &list->cursor->data; \
+	} \
+	if (list->cursor && index == list->cursor_index + 1) { \
+		list->cursor = list->cursor->next; \
+		list->cursor_index = index; \
+		return &list->cursor->data; \
+	} \
+	element = name##_find(index, list); \
+	return element ? &element->data : NULL; \
+} \
+\
+static inline type_t *name##_front(struct name##_t *list) \
+{ \
+	return list && list->head ? &list->head->data : NULL; \
+} \
+\
+static inline type_t *name##_back(struct name##_t *list) \
+{ \
+	return list && list->tail ? &list->tail->data : NULL; \
+} \
+\
+static inline type_t *name##_push_back(type_t value, struct name##_t *list) \
+{ \
+	struct name##_element_t *element = NULL; \
+\
+	if (!list) { \
+		return NULL; \
+	} \
+	element = name##_create_element(list); \
+	if (!element) { \
+		return NULL; \
+	} \
+\
+	/* The indices of the other elements stay the same */ \
+	element->next = NULL; \
+	element->data = value; \
+	if (list->tail) { \
+		list->tail->next = element; \
+	} else { \
+		list->head = element; \
+	} \
+	list->tail = element; \
+	list->size++; \
+	return &element->data; \
+} \
+\
+static inline type_t *name##_push_front(type_t value, struct name##_t *list) \
+{ \
+	struct name##_element_t *element = NULL; \
+\
+	if (!list) { \
+		return NULL; \
+	} \
+	element = name##_create_element(list); \
+	if (!element) { \
+		return NULL; \
+	} \
+\
+	element->next = list->head; \
+	element->data = value; \
+	list->head = element; \
+	if (!list->tail) { \
+		list->tail = element; \
+	} \
+	list->cursor = element; \
+	list->cursor_index = 0; \
+	list->size++; \
+	return &element->data; \
+} \
+\
+static inline int name##_pop_front(struct name##_t *list) \
+{ \
+	struct name##_element_t *element = NULL; \
+\
+	if (!list) { \
+		return 1; \
+	} \
+	if (!list->head) { \
+		return 3; \
+	} \
+\
+	element = list->head; \
+	list->head = element->next; \
+	if (!list->head) { \
+		list->tail = NULL; \
+	} \
+	list->cursor = NULL; \
+	list->cursor_index = 0; \
+	list->size--; \
+	name##_delete_element(element, list); \
+	return 0; \
+}
+
+#define LIST_DEFINE(name, type_t) \
+struct name##_t *name##_create(void) \
+{ \
+	return name##_create_with_allocator(NULL); \
+} \
+\
+struct name##_t *name##_create_with_allocator( \
+        const struct list_allocator_t *allocator) \
+{ \
+	struct name##_t *list = (struct name##_t *) malloc(sizeof(struct name##_t)); \
+\
+	if (!list) { \
+		return NULL; \
+	} \
+\
+	list->head = NULL; \
+	list->tail = NULL; \
+	list->cursor = NULL; \
+	list->cursor_index = 0; \
+	list->size = 0; \
+	list->allocator.allocate = NULL; \
+	list->allocator.deallocate = NULL; \
+	list->allocator.release = NULL; \
+	list->allocator.context = NULL; \
+	if (allocator) { \
+		list->allocator = *allocator; \
+	} \
+	return list; \
+} \
+\
+int name##_clear(struct name##_t *list) \
+{ \
+	struct name##_element_t *element = NULL; \
+	struct name##_element_t *next = NULL; \
+\
+	if (!list) { \
+		return 1; \
+	} \
+\
+	if (list->allocator.release) { \
+		if (list->head) { \
+			list->allocator.release(list->allocator.context); \
+		} \
+	} else { \
+		for (element = list->head; element; element = next) { \
+			next = element->next; \
+			name##_delete_element(element, list); \
+		} \
+	} \
+\
+	list->head = NULL; \
+	list->tail = NULL; \
+	list->cursor = NULL; \
+	list->cursor_index = 0; \
+	list->size = 0; \
+	return 0; \
+} \
+\
+int name##_delete(struct name##_t *list) \
+{ \
+	if (!list) { \
+		return 1; \
+	} \
+	if (name##_clear(list)) { \
+		return 2; \
+	} \
+\
+	free(list); \
+	return 0; \
+} \
+\
+type_t *name##_insert(size_t index, type_t value, struct name##_t *list) \
+{ \
+	struct name##_element_t *element = NULL; \
+	struct name##_element_t *prev = NULL; \
+\
+	if (!list || index > list->size) { \
+		return NULL; \
+	} \
+	if (index == 0) { \
+		return name##_push_front(value, list); \
+	} \
+	if (index == list->size) { \
+		return name##_push_back(value, list); \
+	} \
+\
+	prev = name##_find(index - 1, list); \
+	if (!prev) { \
+		return NULL; \
+	} \
+	element = name##_create_element(list); \
+	if (!element) { \
+		return NULL; \
+	} \
+\
+	element->next = prev->next; \
+	element->data = value; \
+	prev->next = element; \
+	list->cursor = element; \
+	list->cursor_index = index; \
+	list->size++; \
+	return &element->data; \
+} \
+\
+int name##_erase(size_t index, struct name##_t *list) \
+{ \
+	struct name##_element_t *element = NULL; \
+	struct name##_element_t *prev = NULL; \
+\
+	if (!list) { \
+		return 1; \
+	} \
+	if (index >= list->size) { \
+		return 3; \
+	} \
+	if (index == 0) { \
+		return name##_pop_front(list); \
+	} \
+\
+	prev = name##_find(index - 1, list); \
+	if (!prev || !prev->next) { \
+		return 4; \
+	} \
+\
+	element = prev->next; \
+	prev->next = element->next; \
+	if (list->tail == element) { \
+		list->tail = prev; \
+	} \
+	list->size--; \
+	name##_delete_element(element, list); \
+	return 0; \
+} \
+\
+struct name##_element_t *name##_find(size_t index, struct name##_t *list) \
+{ \
+	struct name##_element_t *element = NULL; \
+	size_t i = 0; \
+\
+	if (!list || index >= list->size) { \
+		return NULL; \
+	} \
+	if (index == list->size - 1) { \
+		return list->tail; \
+	} \
+\
+	/* Continue from the last accessed element if it \
+	 * is not past the index, else start from the head */ \
+	if (list->cursor && list->cursor_index <= index) { \
+		element = list->cursor; \
+		i = list->cursor_index; \
+	} else { \
+		element = list->head; \
+	} \
+\
+	for (; i < index && element; i++) { \
+		element = element->next; \
+	} \
+	if (!element) { \
+		return NULL; \
+	} \
+\
+	list->cursor = element; \
+	list->cursor_index = index; \
+	return element; \
+} \
+\
+LIST_DEFINE_VERIFY(name)
+
+/* Define LIST_DEBUG to check the size, tail,
+ * last accessed element and links of a list */
+#ifdef LIST_DEBUG
+
+#define LIST_DECLARE_VERIFY(name) \
+int name##_verify(struct name##_t *list);
+
+#define LIST_DEFINE_VERIFY(name) \
+int name##_verify(struct name##_t *list) \
+{ \
+	struct name##_element_t *element = NULL; \
+	struct name##_element_t *last = NULL; \
+	size_t count = 0; \
+	int cursor_found = 0; \
+\
+	if (!list) { \
+		return 1; \
+	} \
+\
+	for (element = list->head; element; element = element->next) { \
+		if (element == list->cursor && count == list->cursor_index) { \
+			cursor_found = 1; \
+		} \
+		last = element; \
+		count++; \
+	} \
+	if (count != list->size) { \
+		return 2; \
+	} \
+	if (last != list->tail) { \
+		return 3; \
+	} \
+	if (list->cursor && !cursor_found) { \
+		return 4; \
+	} \
+	return 0; \
+}
+
+#else
+
+#define LIST_DECLARE_VERIFY(name)
+#define LIST_DEFINE_VERIFY(name)
+
+#endif
+
+/* TYPEDLIST_H */
+#endif
@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sub-license, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * A Minimal C Unrolled Linked List
+ *   Usage and other information is provided in the README.md file from the
+ *   repository. Please refer to that to know how to use this library.
+ */
+
+#ifndef ULIST_H
+#define ULIST_H "ulist.h"
+
+#include <string.h>
+
+/* The unrolled linked list uses the allocators of the list */
+#include "list.h"
+
+/* Implement the list code by defining
+ * LIST_IMPL before including this library */
+
+/* The default size of a chunk in bytes, a multiple of the cache line */
+#ifndef ULIST_CHUNK_SIZE
+#define ULIST_CHUNK_SIZE 256
+#endif
+
+/* A chunk holds up to the capacity of the list of elements next to each
+ * other, they are placed right after the chunk and aligned for the size
+ * of the type. Chunks are linked in both directions */
+struct uchunk_t {
+	void *next;
+	void *prev;
+	size_t count;
+};
+
+struct ulist_t {
+	/* The first and the last chunk, there are no empty chunks */
+	struct uchunk_t *head;
+	struct uchunk_t *tail;
+	/* The last accessed chunk and the index of its first element,
+	 * walking continues from here when possible */
+	struct uchunk_t *cursor;
+	size_t cursor_index;
+	size_t size;
+	size_t typesize;
+	/* The number of elements a chunk can hold */
+	size_t capacity;
+	/* Chunks are allocated using malloc if there is no allocate */
+	struct list_allocator_t allocator;
+};
+
+
+/* The capacity of a chunk is chosen to fit ULIST_CHUNK_SIZE bytes */
+struct ulist_t *create_ulist(size_t typesize);
+/* The allocator is copied into the list, the chunks are allocated using
+ * malloc if the allocator is NULL. A capacity of 0 uses the default,
+ * a chunk holds at least 2 elements */
+struct ulist_t *create_ulist_with_allocator(size_t typesize, size_t capacity,
+                                            const struct list_allocator_t *allocator);
+
+/* Elements are not separate allocations, these
+ * functions give the pointers to their data */
+void *get_uelement(size_t index, struct ulist_t *list);
+size_t get_ulist_size(struct ulist_t *list);
+
+/* Define LIST_DEBUG to check the size, the
+ * chunks and links of a list */
+#ifdef LIST_DEBUG
+int ulist_verify(struct ulist_t *list);
+#endif
+
+/* These functions are not supposed to be used externally */
+struct uchunk_t *create_uchunk(struct ulist_t *list);
+int delete_uchunk(struct uchunk_t *chunk, struct ulist_t *list);
+struct uchunk_t *find_uchunk(size_t index, size_t *first, struct ulist_t *list);
+void *get_uchunk_data(struct uchunk_t *chunk, size_t offset, struct ulist_t *list);
+
+/* You can add element at the end of the list by giving it the size of the
+ * list. Elements after the index in the same chunk move in memory, so the
+ * pointers to them are no longer valid after adding or removing */
+void *add_uelement(size_t index, struct ulist_t *list);
+int remove_uelement(size_t index, struct ulist_t *list);
+
+int clear_ulist(struct ulist_t *list);
+int delete_ulist(struct ulist_t *list);
+
+#ifdef LIST_IMPL
+
+struct ulist_t *create_ulist(size_t typesize)
+{
+	return create_ulist_with_allocator(typesize, 0, NULL);
+}
+
+struct ulist_t *create_ulist_with_allocator(size_t typesize, size_t capacity,
+                                            const struct list_allocator_t *allocator)
+{
+	struct ulist_t *list = NULL;
+	size_t offset = align_data_offset(sizeof(struct uchunk_t), typesize);
+
+	/* Fit the chunk in the default size, holding at least a few elements */
+	if (capacity == 0) {
+		if (typesize && offset + typesize * 4 < ULIST_CHUNK_SIZE) {
+			capacity = (ULIST_CHUNK_SIZE - offset) / typesize;
+		} else {
+			capacity = 4;
+		}
+	}
+	/* A full chunk is split in two halves, each keeping an element */
+	if (capacity < 2) {
+		capacity = 2;
+	}
+
+	list = (struct ulist_t *) malloc(sizeof(struct ulist_t));
+	if (!list) {
+		return NULL;
+	}
+
+	list->head = NULL;
+	list->tail = NULL;
+	list->cursor = NULL;
+	list->cursor_index = 0;
+	list->size = 0;
+	list->typesize = typesize;
+	list->capacity = capacity;
+	list->allocator.allocate = NULL;
+	list->allocator.deallocate = NULL;
+	list->allocator.release = NULL;
+	list->allocator.context = NULL;
+	if (allocator) {
+		list->allocator = *allocator;
+	}
+	return list;
+}
+
+void *get_uelement(size_t index, struct ulist_t *list)
+{
+	struct uchunk_t *chunk = NULL;
+	size_t first = 0;
+
+	chunk = find_uchunk(index, &first, list);
+	if (!chunk) {
+		return NULL;
+	}
+	return get_uchunk_data(chunk, index - first, list);
+}
+
+size_t get_ulist_size(struct ulist_t *list)
+{
+	if (!list) {
+		return 0;
+	}
+	return list->size;
+}
+
+#ifdef LIST_DEBUG
+int ulist_verify(struct ulist_t *list)
+{
+	struct uchunk_t *chunk = NULL;
+	struct uchunk_t *prev = NULL;
+	size_t size = 0;
+	int cursor_found = 0;
+
+	if (!list) {
+		return 1;
+	}
+	chunk = list->head;
+
+	/* Stop after the size is exceeded, in case the links have a loop */
+	while (chunk && size <= list->size) {
+		if (chunk->prev != (void *) prev) {
+			return 2;
+		}
+		if (chunk->count == 0 || chunk->count > list->capacity) {
+			return 3;
+		}
+		if (chunk == list->cursor) {
+			if (list->cursor_index != size) {
+				return 4;
+			}
+			cursor_found = 1;
+		}
+		size += chunk->count;
+		prev = chunk;
+		chunk = (struct uchunk_t *) chunk->next;
+	}
+
+	if (size != list->size) {
+		return 5;
+	}
+	if (list->tail != prev) {
+		return 6;
+	}
+	if (list->cursor && !cursor_found) {
+		return 4;
+	}
+	return 0;
+}
+#endif
+
+
+
+struct uchunk_t *create_uchunk(struct ulist_t *list)
+{
+	struct uchunk_t *chunk = NULL;
+	size_t size = 0;
+
+	if (!list) {
+		return NULL;
+	}
+
+	size = align_data_offset(sizeof(struct uchunk_t), list->typesize)
+	       + list->typesize * list->capacity;
+	if (list->allocator.allocate) {
+		chunk = (struct uchunk_t *) list->allocator.allocate(
+		                list->allocator.context, size);
+	} else {
+		chunk = (struct uchunk_t *) malloc(size);
+	}
+	if (!chunk) {
+		return NULL;
+	}
+
+	chunk->next = NULL;
+	chunk->prev = NULL;
+	chunk->count = 0;
+	return chunk;
+}
+
+int delete_uchunk(struct uchunk_t *chunk, struct ulist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (!chunk) {
+		return 2;
+	}
+
+	if (list->allocator.deallocate) {
+		list->allocator.deallocate(list->allocator.context, chunk,
+		                           align_data_offset(sizeof(struct uchunk_t), list->typesize)
+		                           + list->typesize * list->capacity);
+	} else {
+		free(chunk);
+	}
+	return 0;
+}
+
+struct uchunk_t *find_uchunk(size_t index, size_t *first, struct ulist_t *list)
+{
+	struct uchunk_t *chunk = NULL;
+	size_t position = 0;
+
+	if (!list || !first) {
+		return NULL;
+	}
+	if (index >= list->size) {
+		return NULL;
+	}
+
+	/* The last chunk is found without walking */
+	if (index >= list->size - list->tail->count) {
+		*first = list->size - list->tail->count;
+		return list->tail;
+	}
+
+	/* Continue from the last accessed chunk if it is not
+	 * past the index, skipping over whole chunks at a time */
+	if (list->cursor && list->cursor_index <= index) {
+		chunk = list->cursor;
+		position = list->cursor_index;
+	} else {
+		chunk = list->head;
+	}
+
+	while (position + chunk->count <= index) {
+		position += chunk->count;
+		chunk = (struct uchunk_t *) chunk->next;
+	}
+
+	list->cursor = chunk;
+	list->cursor_index = position;
+	*first = position;
+	return chunk;
+}
+
+void *get_uchunk_data(struct uchunk_t *chunk, size_t offset, struct ulist_t *list)
+{
+	return (void *) ((char *) chunk
+	                 + align_data_offset(sizeof(struct uchunk_t), list->typesize)
+	                 + offset * list->typesize);
+}
+
+
+
+void *add_uelement(size_t index, struct ulist_t *list)
+{
+	struct uchunk_t *chunk = NULL;
+	struct uchunk_t *new_chunk = NULL;
+	size_t first = 0;
+	size_t offset = 0;
+	size_t half = 0;
+	char *data = NULL;
+
+	if (!list) {
+		return NULL;
+	}
+	if (index > list->size) {
+		return NULL;
+	}
+
+	/* An empty list gets its first chunk */
+	if (!list->head) {
+		chunk = create_uchunk(list);
+		if (!chunk) {
+			return NULL;
+		}
+		list->head = chunk;
+		list->tail = chunk;
+	} else if (index == list->size) {
+		chunk = list->tail;
+		first = list->size - chunk->count;
+	} else {
+		chunk = find_uchunk(index, &first, list);
+	}
+	offset = index - first;
+
+	/* A full chunk is split in half, the second half moves to a new
+	 * chunk. Adding at the end of the list leaves the full chunk as is */
+	if (chunk->count == list->capacity) {
+		new_chunk = create_uchunk(list);
+		if (!new_chunk) {
+			return NULL;
+		}
+		half = (offset == chunk->count) ? chunk->count : chunk->count / 2;
+		new_chunk->count = chunk->count - half;
+		memcpy(get_uchunk_data(new_chunk, 0, list),
+		       get_uchunk_data(chunk, half, list),
+		       new_chunk->count * list->typesize);
+		chunk->count = half;
+
+		new_chunk->prev = (void *) chunk;
+		new_chunk->next = chunk->next;
+		if (chunk->next) {
+			((struct uchunk_t *) chunk->next)->prev = (void *) new_chunk;
+		} else {
+			list->tail = new_chunk;
+		}
+		chunk->next = (void *) new_chunk;
+
+		if (offset >= half) {
+			chunk = new_chunk;
+			first += half;
+			offset -= half;
+		}
+	}
+
+	data = (char *) get_uchunk_data(chunk, offset, list);
+	memmove(data + list->typesize, data,
+	        (chunk->count - offset) * list->typesize);
+	chunk->count++;
+	list->size++;
+
+	list->cursor = chunk;
+	list->cursor_index = first;
+	return (void *) data;
+}
+
+int remove_uelement(size_t index, struct ulist_t *list)
+{
+	struct uchunk_t *chunk = NULL;
+	struct uchunk_t *next = NULL;
+	struct uchunk_t *prev = NULL;
+	size_t first = 0;
+	size_t offset = 0;
+	char *data = NULL;
+
+	if (!list) {
+		return 1;
+	}
+	if (index >= list->size) {
+		return 3;
+	}
+
+	chunk = find_uchunk(index, &first, list);
+	if (!chunk) {
+		return 4;
+	}
+	offset = index - first;
+
+	data = (char *) get_uchunk_data(chunk, offset, list);
+	memmove(data, data + list->typesize,
+	        (chunk->count - offset - 1) * list->typesize);
+	chunk->count--;
+	list->size--;
+
+	next = (struct uchunk_t *) chunk->next;
+	prev = (struct uchunk_t *) chunk->prev;
+	list->cursor = chunk;
+	list->cursor_index = first;
+
+	/* An empty chunk is unlinked and deleted */
+	if (chunk->count == 0) {
+		if (prev) {
+			prev->next = (void *) next;
+		} else {
+			list->head = next;
+		}
+		if (next) {
+			next->prev = (void *) prev;
+		} else {
+			list->tail = prev;
+		}
+		list->cursor = NULL;
+		return delete_uchunk(chunk, list) ? 6 : 0;
+	}
+
+	/* A chunk less than half full takes the elements of the
+	 * next chunk if they fit, and the next chunk is deleted */
+	if (next && chunk->count < list->capacity / 2
+	    && chunk->count + next->count <= list->capacity) {
+		memcpy(get_uchunk_data(chunk, chunk->count, list),
+		       get_uchunk_data(next, 0, list),
+		       next->count * list->typesize);
+		chunk->count += next->count;
+		chunk->next = next->next;
+		if (next->next) {
+			((struct uchunk_t *) next->next)->prev = (void *) chunk;
+		} else {
+			list->tail = chunk;
+		}
+		return delete_uchunk(next, list) ? 6 : 0;
+	}
+	return 0;
+}
+
+
+
+int clear_ulist(struct ulist_t *list)
+{
+	struct uchunk_t *chunk = NULL;
+	struct uchunk_t *next = NULL;
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+	if (list->size == 0) {
+		/* This is not considered an error */
+		return 0;
+	}
+
+	/* The allocator can free all the chunks at once,
+	 * otherwise every chunk is deleted in a single pass */
+	if (list->allocator.release) {
+		list->allocator.release(list->allocator.context);
+	} else {
+		chunk = list->head;
+		while (chunk) {
+			next = (struct uchunk_t *) chunk->next;
+			if (delete_uchunk(chunk, list)) {
+				error = 2;
+			}
+			chunk = next;
+		}
+	}
+
+	list->head = NULL;
+	list->tail = NULL;
+	list->cursor = NULL;
+	list->cursor_index = 0;
+	list->size = 0;
+	return error;
+}
+
+int delete_ulist(struct ulist_t *list)
+{
+	if (!list) {
+		return 1;
+	}
+	if (clear_ulist(list)) {
+		return 2;
+	}
+
+	free(list);
+	return 0;
+}
+
+/* LIST_IMPL */
+#endif
+
+/* ULIST_H */
+#endif
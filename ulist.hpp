@@ -0,0 +1,348 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2023 Anstro Pleuton (@AnstroPleuton)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// The unrolled backend for the C++ Wrapper of the Minimal C Linked List
+//   Usage and other information is provided in the README.md file from the
+//   repository. Please refer to that to know how to use this library.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ULIST_HPP
+#define ULIST_HPP "ulist.hpp"
+
+// This header is just a wrapper for the Minimal C Unrolled Linked List
+#include "ulist.h"
+#include "list.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace aplib
+{
+// The unrolled backend keeps elements next to each other in chunks,
+// going through the list and finding an index skip over whole chunks
+struct unrolled
+{
+	// A position is an element of a chunk, the end has no chunk
+	struct position_t
+	{
+		uchunk_t *chunk;
+		size_t offset;
+		ulist_t *list;
+
+		bool operator==(const position_t &compare) const;
+		bool operator!=(const position_t &compare) const;
+	};
+
+	using internal_t = ulist_t;
+	using iterator_category = std::forward_iterator_tag;
+	// Elements are moved in memory when adding and removing
+	static constexpr bool moves_elements = true;
+
+	static internal_t *create(size_t typesize,
+	                          const list_allocator_t *allocator);
+	static int destroy(internal_t *list);
+	static int clear(internal_t *list);
+	static size_t size(internal_t *list);
+
+	static void *get(size_t index, internal_t *list);
+	static void *add(size_t index, internal_t *list);
+	static int remove(size_t index, internal_t *list);
+	static int remove(size_t index, size_t count, internal_t *list);
+
+	static position_t begin(internal_t *list);
+	static position_t end(internal_t *list);
+	static position_t next(position_t position);
+	static void *data(position_t position);
+
+	// Adding before a position and removing at a position walk
+	// the chunks to find the index of the position
+	static position_t insert(position_t position, internal_t *list);
+	static position_t erase(position_t position, internal_t *list);
+
+	// Splicing and splitting copy the elements to the other list
+	static int splice(size_t index, internal_t *other, internal_t *list);
+	static internal_t *split(size_t index, internal_t *list);
+	// Sorting copies the elements out in order and back in
+	static int sort(int (*compare)(const void *, const void *, void *),
+	                void *context, internal_t *list);
+	// The kept elements are copied over the removed ones
+	static int unique(int (*compare)(const void *, const void *, void *),
+	                  void *context, internal_t *list);
+
+	// The position of an index, the end if it is past the last element
+	static position_t find(size_t index, internal_t *list);
+
+	// These functions are not supposed to be used externally
+	static size_t index(position_t position, internal_t *list);
+};
+
+template<typename type_t, typename alloc_t = std::allocator<type_t>>
+using ulist = list<type_t, alloc_t, unrolled>;
+}
+
+#ifdef LIST_IMPL
+
+bool aplib::unrolled::position_t::operator==(const position_t &compare) const
+{
+	return chunk == compare.chunk && offset == compare.offset;
+}
+
+bool aplib::unrolled::position_t::operator!=(const position_t &compare) const
+{
+	return !(*this == compare);
+}
+
+aplib::unrolled::internal_t *aplib::unrolled::create(size_t typesize,
+        const list_allocator_t *allocator)
+{
+	return create_ulist_with_allocator(typesize, 0, allocator);
+}
+
+int aplib::unrolled::destroy(internal_t *list)
+{
+	return delete_ulist(list);
+}
+
+int aplib::unrolled::clear(internal_t *list)
+{
+	return clear_ulist(list);
+}
+
+size_t aplib::unrolled::size(internal_t *list)
+{
+	return get_ulist_size(list);
+}
+
+void *aplib::unrolled::get(size_t index, internal_t *list)
+{
+	return get_uelement(index, list);
+}
+
+void *aplib::unrolled::add(size_t index, internal_t *list)
+{
+	return add_uelement(index, list);
+}
+
+int aplib::unrolled::remove(size_t index, internal_t *list)
+{
+	return remove_uelement(index, list);
+}
+
+int aplib::unrolled::remove(size_t index, size_t count, internal_t *list)
+{
+	int error = 0;
+
+	if (!list) {
+		return 1;
+	}
+	if (count == 0) {
+		return 0;
+	}
+	if (index >= list->size || count > list->size - index) {
+		return 3;
+	}
+
+	// Removing from the last one keeps the elements after the range
+	// from moving more than once, and the last chunk is found at once
+	for (; count > 0 && !error; count--) {
+		error = remove_uelement(index + count - 1, list);
+	}
+	return error;
+}
+
+aplib::unrolled::position_t aplib::unrolled::begin(internal_t *list)
+{
+	return position_t {list->head, 0, list};
+}
+
+aplib::unrolled::position_t aplib::unrolled::end(internal_t *list)
+{
+	return position_t {nullptr, 0, list};
+}
+
+aplib::unrolled::position_t aplib::unrolled::next(position_t position)
+{
+	if (++position.offset == position.chunk->count) {
+		position.chunk = (uchunk_t *) position.chunk->next;
+		position.offset = 0;
+	}
+	return position;
+}
+
+void *aplib::unrolled::data(position_t position)
+{
+	return get_uchunk_data(position.chunk, position.offset, position.list);
+}
+
+aplib::unrolled::position_t aplib::unrolled::insert(position_t position,
+        internal_t *list)
+{
+	size_t added = index(position, list);
+
+	if (!add_uelement(added, list)) {
+		return end(list);
+	}
+	return find(added, list);
+}
+
+aplib::unrolled::position_t aplib::unrolled::erase(position_t position,
+        internal_t *list)
+{
+	size_t removed = index(position, list);
+
+	remove_uelement(removed, list);
+	return find(removed, list);
+}
+
+int aplib::unrolled::splice(size_t index, internal_t *other, internal_t *list)
+{
+	position_t position = begin(other);
+	size_t added = 0;
+	void *element = nullptr;
+
+	if (other->typesize != list->typesize) {
+		return 2;
+	}
+	for (; position != end(other); position = next(position), added++) {
+		element = add_uelement(index + added, list);
+		if (!element) {
+			while (added--) {
+				remove_uelement(index, list);
+			}
+			return 2;
+		}
+		memcpy(element, data(position), list->typesize);
+	}
+	return clear_ulist(other);
+}
+
+aplib::unrolled::internal_t *aplib::unrolled::split(size_t index, internal_t *list)
+{
+	internal_t *split = create_ulist_with_allocator(list->typesize, list->capacity,
+	                    list->allocator.allocate ? &list->allocator : nullptr);
+	position_t position = find(index, list);
+	void *element = nullptr;
+
+	if (!split) {
+		return nullptr;
+	}
+	for (; position != end(list); position = next(position)) {
+		element = add_uelement(split->size, split);
+		if (!element) {
+			destroy(split);
+			return nullptr;
+		}
+		memcpy(element, data(position), list->typesize);
+	}
+
+	// Removing from the end does not move any of the elements
+	while (list->size > index) {
+		remove_uelement(list->size - 1, list);
+	}
+	return split;
+}
+
+int aplib::unrolled::sort(int (*compare)(const void *, const void *, void *),
+                           void *context, internal_t *list)
+{
+	std::vector<void *> elements;
+	std::vector<char> sorted;
+	position_t position = begin(list);
+	size_t i = 0;
+
+	for (; position != end(list); position = next(position)) {
+		elements.push_back(data(position));
+	}
+	std::stable_sort(elements.begin(), elements.end(),
+	[compare, context](void *first, void *second) {
+		return compare(second, first, context) > 0;
+	});
+
+	// The elements are copied out in order and back into the list
+	sorted.resize(elements.size() * list->typesize);
+	for (i = 0; i < elements.size(); i++) {
+		memcpy(sorted.data() + i * list->typesize, elements[i], list->typesize);
+	}
+	for (i = 0, position = begin(list); position != end(list);
+	     i++, position = next(position)) {
+		memcpy(data(position), sorted.data() + i * list->typesize, list->typesize);
+	}
+	return 0;
+}
+
+int aplib::unrolled::unique(int (*compare)(const void *, const void *, void *),
+                            void *context, internal_t *list)
+{
+	position_t kept = begin(list);
+	position_t position = begin(list);
+	size_t count = 1;
+
+	if (list->size < 2) {
+		return 0;
+	}
+
+	// The elements are trivially copyable, those after the kept ones
+	// are removed at once
+	for (position = next(position); position != end(list);
+	     position = next(position)) {
+		if (compare(data(kept), data(position), context)) {
+			kept = next(kept);
+			if (kept != position) {
+				memcpy(data(kept), data(position), list->typesize);
+			}
+			count++;
+		}
+	}
+	return remove(count, list->size - count, list);
+}
+
+size_t aplib::unrolled::index(position_t position, internal_t *list)
+{
+	uchunk_t *chunk = list->head;
+	size_t first = 0;
+
+	if (!position.chunk) {
+		return list->size;
+	}
+	while (chunk != position.chunk) {
+		first += chunk->count;
+		chunk = (uchunk_t *) chunk->next;
+	}
+	return first + position.offset;
+}
+
+aplib::unrolled::position_t aplib::unrolled::find(size_t index,
+        internal_t *list)
+{
+	size_t first = 0;
+	uchunk_t *chunk = find_uchunk(index, &first, list);
+
+	if (!chunk) {
+		return end(list);
+	}
+	return position_t {chunk, index - first, list};
+}
+
+// LIST_IMPL
+#endif
+
+// ULIST_HPP
+#endif